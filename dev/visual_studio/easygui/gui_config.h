@@ -45,7 +45,6 @@
 #define GUI_CFG_USE_ALPHA                       1
 #define GUI_CFG_USE_UNICODE                     1
 #define GUI_CFG_SYS_PORT                        GUI_SYS_PORT_WIN32
-#define GUI_CFG_USE_POS_SIZE_CACHE              1
 
 /* After user configuration, call default config to merge config together */
 #include "gui/gui_config_default.h"
@@ -47,66 +47,26 @@ gui_t GUI;
  */
 static void
 check_disp_clipping(gui_handle_p h) {
-#if !GUI_CFG_USE_POS_SIZE_CACHE
-    gui_dim_t x, y, wi, hi;
-#endif /* !GUI_CFG_USE_POS_SIZE_CACHE */
+    gui_dim_t x1, y1, x2, y2;
     
     /* Copy current setup */
     memcpy(&GUI.display_temp, &GUI.display, sizeof(GUI.display_temp));
     
-#if GUI_CFG_USE_POS_SIZE_CACHE
-    if (GUI.display_temp.x1 == GUI_DIM_MAX || GUI.display_temp.x1 < h->abs_visible_x1) {
-        GUI.display_temp.x1 = h->abs_visible_x1;
-    }
-    if (GUI.display_temp.y1 == GUI_DIM_MAX || GUI.display_temp.y1 < h->abs_visible_y1) {
-        GUI.display_temp.y1 = h->abs_visible_y1;
-    }
-    if (GUI.display_temp.x2 == GUI_DIM_MIN || GUI.display_temp.x2 > h->abs_visible_x2) {
-        GUI.display_temp.x2 = h->abs_visible_x2;
-    }
-    if (GUI.display_temp.y2 == GUI_DIM_MIN || GUI.display_temp.y2 > h->abs_visible_y2) {
-        GUI.display_temp.y2 = h->abs_visible_y2;
-    }
-#else /* GUI_CFG_USE_POS_SIZE_CACHE */
-
-    /* Set widget itself first */
-    x = gui_widget_getabsolutex(h); 
-    y = gui_widget_getabsolutey(h); 
-    wi = gui_widget_getwidth(h);   
-    hi = gui_widget_getheight(h);   
+    /* Get cached visible area of widget, which is already limited by all parent widgets */
+    guii_widget_getabsvisibleposition(h, &x1, &y1, &x2, &y2);
     
-    /* Step 1: Set active clipping area only for current widget */
-    if (GUI.display_temp.x1 == GUI_DIM_MAX || GUI.display_temp.x1 < x) {
-        GUI.display_temp.x1 = x;
+    if (GUI.display_temp.x1 == GUI_DIM_MAX || GUI.display_temp.x1 < x1) {
+        GUI.display_temp.x1 = x1;
     }
-    if (GUI.display_temp.y1 == GUI_DIM_MAX || GUI.display_temp.y1 < y) {
-        GUI.display_temp.y1 = y;
+    if (GUI.display_temp.y1 == GUI_DIM_MAX || GUI.display_temp.y1 < y1) {
+        GUI.display_temp.y1 = y1;
     }
-    if (GUI.display_temp.x2 == GUI_DIM_MIN || GUI.display_temp.x2 > (x + wi)) {
-        GUI.display_temp.x2 = x + wi;
+    if (GUI.display_temp.x2 == GUI_DIM_MIN || GUI.display_temp.x2 > x2) {
+        GUI.display_temp.x2 = x2;
     }
-    if (GUI.display_temp.y2 == GUI_DIM_MIN || GUI.display_temp.y2 > (y + hi)) {
-        GUI.display_temp.y2 = y + hi;
+    if (GUI.display_temp.y2 == GUI_DIM_MIN || GUI.display_temp.y2 > y2) {
+        GUI.display_temp.y2 = y2;
     }
-    
-    /*
-     * Step 2: Set active clipping area, combining all parent together
-     * 
-     * Process all parent widgets and check what is the position of them
-     * Make sure that on current widget we only draw actual visible area
-     */
-    for (; h != NULL; h = guii_widget_getparent(h)) {
-        x = guii_widget_getparentabsolutex(h);     /* Parent absolute X position for inner widgets */
-        y = guii_widget_getparentabsolutey(h);     /* Parent absolute Y position for inner widgets */
-        wi = guii_widget_getparentinnerwidth(h);   /* Get parent inner width */
-        hi = guii_widget_getparentinnerheight(h);  /* Get parent inner height */
-
-        GUI.display_temp.x1 = GUI_MAX(GUI.display_temp.x1, x);
-        GUI.display_temp.x2 = GUI_MIN(GUI.display_temp.x2, x + wi);
-        GUI.display_temp.y1 = GUI_MAX(GUI.display_temp.y1, y);
-        GUI.display_temp.y2 = GUI_MIN(GUI.display_temp.y2, y + hi);
-    }
-#endif /* !GUI_CFG_USE_POS_SIZE_CACHE */
 }
 
 /**
@@ -146,10 +106,13 @@ redraw_widgets(gui_handle_p parent, uint8_t force_redraw) {
                     gui_dim_t width = GUI.display_temp.x2 - GUI.display_temp.x1;
                     gui_dim_t height = GUI.display_temp.y2 - GUI.display_temp.y1;
                     
-                    /* Try to allocate memory for new virtual layer for temporary usage */
-                    GUI.lcd.drawing_layer = GUI_MEMALLOC(sizeof(*GUI.lcd.drawing_layer) + (size_t)width * (size_t)height * (size_t)GUI.lcd.pixel_size);
+                    size_t size = sizeof(*GUI.lcd.drawing_layer) + (size_t)width * (size_t)height * (size_t)GUI.lcd.pixel_size;
+                    
+                    /* Try to allocate memory for new virtual layer from frame memory, nested layers reuse the same memory */
+                    GUI.lcd.drawing_layer = gui_mem_frame_alloc(size);
                     
                     if (GUI.lcd.drawing_layer != NULL) {/* Check if allocation was successful */
+                        memset(GUI.lcd.drawing_layer, 0x00, size);
                         GUI.lcd.drawing_layer->width = width;
                         GUI.lcd.drawing_layer->height = height;
                         GUI.lcd.drawing_layer->x_pos = GUI.display_temp.x1;
@@ -223,7 +186,7 @@ redraw_widgets(gui_handle_p parent, uint8_t force_redraw) {
                         }                        
                     }
                     
-                    GUI_MEMFREE(GUI.lcd.drawing_layer); /* Free memory for virtual layer */
+                    gui_mem_frame_free(GUI.lcd.drawing_layer);  /* Free memory for virtual layer */
                     GUI.lcd.drawing_layer = layerPrev;  /* Reset layer pointer */
                 }
 #endif /* GUI_CFG_USE_ALPHA */
@@ -240,6 +203,9 @@ redraw_widgets(gui_handle_p parent, uint8_t force_redraw) {
 
 #if GUI_CFG_USE_TOUCH
 
+static uint8_t TouchWait;                           /* Set to `1` when touch thread waits for timeout */
+static uint32_t TouchWaitTime;                      /* Time when touch thread timeout expires */
+
 /**
  * \brief           Set relative coordinate of touch on widget
  *
@@ -279,15 +245,237 @@ set_relative_coordinate(guii_touch_data_t* ts, gui_touch_data_t* old, gui_handle
         ts->x_rel[i] = ts->ts.x[i] - ts->widget_x;
         ts->y_rel[i] = ts->ts.y[i] - ts->widget_y;
     }
+}
+
+#define GESTURE_FLAG_PAN            0x01            /*!< Pan gesture is active */
+#define GESTURE_FLAG_PINCH          0x02            /*!< Pinch gesture is active */
+#define GESTURE_FLAG_ROTATE         0x04            /*!< Rotate gesture is active */
+#define GESTURE_FLAG_HANDLED        0x08            /*!< Gesture event was processed by widget during current press */
+
+/**
+ * \brief           Send gesture event to active widget and then to its parents until processed
+ * \param[in]       evt: Gesture event
+ * \param[in]       state: Gesture state
+ * \return          `1` if event was processed, `0` otherwise
+ */
+static uint8_t
+gesture_send(gui_widget_evt_t evt, gui_gesture_state_t state) {
+    gui_evt_param_t param = {0};
+    gui_gesture_t* g = &GUI.touch.gesture;
+    gui_handle_p h;
+
+    g->state = state;
+    GUI_EVT_PARAMTYPE_TOUCH(&param) = &GUI.touch;
+    for (h = GUI.active_widget; h != NULL; h = guii_widget_getparent(h)) {
+        g->x = g->abs_x - gui_widget_getabsolutex(h);   /* Position relative to widget receiving event */
+        g->y = g->abs_y - gui_widget_getabsolutey(h);
+        if (guii_widget_callback(h, evt, &param, NULL)) {
+            g->flags |= GESTURE_FLAG_HANDLED;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Set absolute gesture position, first touch or center between `2` touches
+ * \param[in]       ts: Touch data
+ */
+static void
+gesture_setposition(const gui_touch_data_t* ts) {
+    gui_gesture_t* g = &GUI.touch.gesture;
+
+    g->abs_x = ts->x[0];
+    g->abs_y = ts->y[0];
+#if GUI_CFG_TOUCH_MAX_PRESSES > 1
+    if (ts->count == 2) {
+        g->abs_x = (ts->x[0] + ts->x[1]) / 2;
+        g->abs_y = (ts->y[0] + ts->y[1]) / 2;
+    }
+#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
+}
+
+/**
+ * \brief           Calculate velocity of first touch from touch history
+ *
+ *                  Velocity is slope of least squares line fit of position versus time
+ *                  for points in last \ref GUI_CFG_GESTURE_VELOCITY_WINDOW milliseconds
+ *
+ * \note            Velocity is always `0` when \ref GUI_CFG_TOUCH_HISTORY is less than `2`
+ * \param[in]       time: Release time
+ */
+static void
+gesture_calcvelocity(uint32_t time) {
+    gui_gesture_t* g = &GUI.touch.gesture;
+#if GUI_CFG_TOUCH_HISTORY > 1
+    gui_touch_point_t p[GUI_CFG_TOUCH_HISTORY];
+    float mt = 0, mx = 0, my = 0, stt = 0, stx = 0, sty = 0, t;
+    size_t n, i, first;
+#endif /* GUI_CFG_TOUCH_HISTORY > 1 */
+
+    g->vx = g->vy = 0;
+#if GUI_CFG_TOUCH_HISTORY > 1
+    n = guii_input_touchgethistory(0, p, GUI_COUNT_OF(p));
+    if (n < 2 || (time - p[n - 1].time) > GUI_CFG_GESTURE_VELOCITY_WINDOW) {  /* Touch stopped before release */
+        return;
+    }
+    for (first = 0; (p[n - 1].time - p[first].time) > GUI_CFG_GESTURE_VELOCITY_WINDOW; first++) {}
+    if (n - first < 2) {
+        return;
+    }
 
+    /* Calculate mean values, time is relative to latest point */
+    for (i = first; i < n; i++) {
+        mt -= (float)(p[n - 1].time - p[i].time);
+        mx += (float)p[i].x;
+        my += (float)p[i].y;
+    }
+    mt /= (float)(n - first);
+    mx /= (float)(n - first);
+    my /= (float)(n - first);
+
+    /* Calculate slopes */
+    for (i = first; i < n; i++) {
+        t = -(float)(p[n - 1].time - p[i].time) - mt;
+        stt += t * t;
+        stx += t * ((float)p[i].x - mx);
+        sty += t * ((float)p[i].y - my);
+    }
+    if (stt > 0) {
+        g->vx = 1000.0f * stx / stt;                /* Convert pixels per millisecond to pixels per second */
+        g->vy = 1000.0f * sty / stt;
+    }
+#else /* GUI_CFG_TOUCH_HISTORY > 1 */
+    GUI_UNUSED(time);                               /* At least `2` points are needed for velocity */
+#endif /* !(GUI_CFG_TOUCH_HISTORY > 1) */
+}
+
+/**
+ * \brief           Start gesture recognition on new press or on change of number of touches
+ */
+static void
+gesture_start(void) {
+    gui_gesture_t* g = &GUI.touch.gesture;
+    gui_touch_data_t* ts = &GUI.touch.ts;
+    uint8_t flags = g->flags & GESTURE_FLAG_HANDLED;
+
+    memset(g, 0x00, sizeof(*g));
+    g->flags = flags;
+    g->scale = 1.0f;
+    gesture_setposition(ts);
+    g->start_x = g->abs_x;
+    g->start_y = g->abs_y;
 #if GUI_CFG_TOUCH_MAX_PRESSES > 1
-    if (ts->ts.count == 2) {                        /* 2 points detected */
-        ts->distance_old = ts->distance;            /* Save old distance */
-        gui_math_distancebetweenxy(ts->x_rel[0], ts->y_rel[0], ts->x_rel[1], ts->y_rel[1], &ts->distance);  /* Calculate distance between 2 points */
+    if (ts->count == 2) {
+        gui_math_distancebetweenxy(ts->x[0], ts->y[0], ts->x[1], ts->y[1], &g->distance);
+        gui_math_anglebetweenxy(ts->x[0], ts->y[0], ts->x[1], ts->y[1], &g->angle);
     }
 #endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
 }
 
+/**
+ * \brief           Finish active gestures
+ * \param[in]       release: Set to `1` when touch was released to detect fling, `0` otherwise
+ */
+static void
+gesture_finish(uint8_t release) {
+    gui_gesture_t* g = &GUI.touch.gesture;
+
+    if (g->flags & GESTURE_FLAG_PAN) {
+        g->dx = g->dy = 0;
+        if (release) {
+            gesture_calcvelocity(GUI.touch.ts.time);
+        }
+        gesture_send(GUI_EVT_PAN, GUI_GESTURE_STATE_END);
+        if (release && (g->vx * g->vx + g->vy * g->vy) >= (float)GUI_CFG_GESTURE_FLING_VELOCITY * (float)GUI_CFG_GESTURE_FLING_VELOCITY) {
+            gesture_send(GUI_EVT_FLING, GUI_GESTURE_STATE_END);
+        }
+    }
+    if (g->flags & GESTURE_FLAG_PINCH) {
+        g->scale = 1.0f;
+        gesture_send(GUI_EVT_PINCH, GUI_GESTURE_STATE_END);
+    }
+    if (g->flags & GESTURE_FLAG_ROTATE) {
+        g->rotation = 0;
+        gesture_send(GUI_EVT_ROTATE, GUI_GESTURE_STATE_END);
+    }
+    g->flags &= ~(GESTURE_FLAG_PAN | GESTURE_FLAG_PINCH | GESTURE_FLAG_ROTATE);
+}
+
+/**
+ * \brief           Recognize gestures on touch move
+ */
+static void
+gesture_move(void) {
+    gui_gesture_t* g = &GUI.touch.gesture;
+    gui_touch_data_t* ts = &GUI.touch.ts;
+    gui_dim_t x = g->abs_x, y = g->abs_y;
+
+    if (ts->count != GUI.touch_old.count) {         /* Number of touches changed, start again */
+        gesture_finish(0);
+        gesture_start();
+        return;
+    }
+    gesture_setposition(ts);
+    g->total_x = g->abs_x - g->start_x;
+    g->total_y = g->abs_y - g->start_y;
+
+    if (ts->count == 1) {
+        if (!(g->flags & GESTURE_FLAG_PAN)) {
+            if (GUI_ABS(g->total_x) > GUI_CFG_GESTURE_PAN_SLOP || GUI_ABS(g->total_y) > GUI_CFG_GESTURE_PAN_SLOP) {
+                g->flags |= GESTURE_FLAG_PAN;
+                g->dx = g->total_x;                 /* Report all movement since press */
+                g->dy = g->total_y;
+                gesture_send(GUI_EVT_PAN, GUI_GESTURE_STATE_BEGIN);
+            }
+        } else if (g->abs_x != x || g->abs_y != y) {
+            g->dx = g->abs_x - x;
+            g->dy = g->abs_y - y;
+            gesture_send(GUI_EVT_PAN, GUI_GESTURE_STATE_UPDATE);
+        }
+#if GUI_CFG_TOUCH_MAX_PRESSES > 1
+    } else if (ts->count == 2) {
+        float distance, angle;
+
+        gui_math_distancebetweenxy(ts->x[0], ts->y[0], ts->x[1], ts->y[1], &distance);
+        if (g->distance > 0 && distance > 0) {
+            if (!(g->flags & GESTURE_FLAG_PINCH)) {
+                if (GUI_ABS(distance - g->distance) > GUI_CFG_GESTURE_PINCH_SLOP) {
+                    g->flags |= GESTURE_FLAG_PINCH;
+                    g->scale = distance / g->distance;
+                    g->distance = distance;
+                    gesture_send(GUI_EVT_PINCH, GUI_GESTURE_STATE_BEGIN);
+                }
+            } else if (distance != g->distance) {
+                g->scale = distance / g->distance;
+                g->distance = distance;
+                gesture_send(GUI_EVT_PINCH, GUI_GESTURE_STATE_UPDATE);
+            }
+        } else {
+            g->distance = distance;                 /* Touches were on the same point */
+        }
+        if (gui_math_anglebetweenxy(ts->x[0], ts->y[0], ts->x[1], ts->y[1], &angle)) {
+            g->rotation = angle - g->angle;
+            if (g->rotation > 180) {                /* Use shorter direction */
+                g->rotation -= 360;
+            } else if (g->rotation < -180) {
+                g->rotation += 360;
+            }
+            if (!(g->flags & GESTURE_FLAG_ROTATE)) {
+                if (GUI_ABS(g->rotation) > GUI_CFG_GESTURE_ROTATE_SLOP) {
+                    g->flags |= GESTURE_FLAG_ROTATE;
+                    g->angle = angle;
+                    gesture_send(GUI_EVT_ROTATE, GUI_GESTURE_STATE_BEGIN);
+                }
+            } else if (g->rotation != 0) {
+                g->angle = angle;
+                gesture_send(GUI_EVT_ROTATE, GUI_GESTURE_STATE_UPDATE);
+            }
+        }
+#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
+    }
+}
+
 /*
  * How touch events work
  *
@@ -348,6 +536,7 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* const ts, gui_touch_data_t* co
     for (i = 0; i < 2;) {                           /* Allow up to 2 touch presses */
 
         /* Wait for valid input with pressed state */
+        TouchWait = 0;                              /* No timeout until touch is pressed */
         PT_WAIT_UNTIL(&ts->pt, v && ts->ts.status && !old->status && ts->ts.count == 1);
 
         time = ts->ts.time;                         /* Get start time of this touch */
@@ -356,6 +545,8 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* const ts, gui_touch_data_t* co
         
         /* Either wait for released status or timeout */
         do {
+            TouchWait = 1;                          /* Process thread again when long click time expires */
+            TouchWaitTime = time + GUI_CFG_LONG_CLICK_TIMEOUT + 1;
             PT_YIELD(&ts->pt);                      /* Stop thread for now and wait next call */
 
             /* Wait for new data */
@@ -390,7 +581,7 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* const ts, gui_touch_data_t* co
 
                 /* Try to get second click, check difference for double click */
                 /* Difference was too big, reset and act like normal click */
-                if (i && (GUI_ABS(x[0] - x[1]) > 30 || GUI_ABS(y[0] - y[1]) > 30)) {
+                if (i && (GUI_ABS(x[0] - x[1]) > GUI_CFG_DBLCLICK_DISTANCE || GUI_ABS(y[0] - y[1]) > GUI_CFG_DBLCLICK_DISTANCE)) {
                     i = 0;
                 }
                 set_relative_coordinate(ts, old, GUI.active_widget);
@@ -406,11 +597,13 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* const ts, gui_touch_data_t* co
                     *result = GUI_EVT_CLICK;        /* Click event occurred */
 
                     time = ts->ts.time;             /* Save last time */
+                    TouchWait = 1;                  /* Process thread again when double click time expires */
+                    TouchWaitTime = time + GUI_CFG_DBLCLICK_TIMEOUT + 1;
                     PT_YIELD(&ts->pt);              /* Stop thread for now and wait next call with new touch event */
 
                     /* Wait for valid input with pressed state */
-                    PT_WAIT_UNTIL(&ts->pt, (v && ts->ts.status) || (gui_sys_now() - time) > 300);
-                    if ((gui_sys_now() - time) > 300) { /* Check timeout for new pressed state */
+                    PT_WAIT_UNTIL(&ts->pt, (v && ts->ts.status) || (gui_sys_now() - time) > GUI_CFG_DBLCLICK_TIMEOUT);
+                    if ((gui_sys_now() - time) > GUI_CFG_DBLCLICK_TIMEOUT) {   /* Check timeout for new pressed state */
                         PT_EXIT(&ts->pt);           /* Exit protothread */
                     }
                 } else {
@@ -429,11 +622,31 @@ PT_THREAD(__TouchEvents_Thread(guii_touch_data_t* const ts, gui_touch_data_t* co
     PT_END(&ts->pt);                                /* Stop thread execution */
 }
 
+/**
+ * \brief           Check if touch position is inside visible area of widget
+ *
+ * \note            Visible area of children widgets is always inside visible area of parent widget.
+ *                  When touch is outside widget, none of its children widgets can be touched either
+ *
+ * \param[in]       touch: Touch data info
+ * \param[in]       h: Widget handle
+ * \return          `1` if touch is inside widget visible area, `0` otherwise
+ */
+static uint8_t
+is_touch_inside_widget(guii_touch_data_t* const touch, gui_handle_p h) {
+    gui_dim_t x1, y1, x2, y2;
+    
+    guii_widget_getabsvisibleposition(h, &x1, &y1, &x2, &y2);   /* Get cached visible area */
+    return touch->ts.x[0] >= x1 && touch->ts.x[0] <= x2 &&
+            touch->ts.y[0] >= y1 && touch->ts.y[0] <= y2;
+}
+
 /**
  * \brief           Process input touch event
  *                  
  *                  Scan all widgets from top to bottom which will be first on valid 
- *                  position for touch and call callback function to this widget
+ *                  position for touch and call callback function to this widget.
+ *                  Widgets where touch is outside visible area are skipped together with all their children
  * \param[in]       touch: Touch data info
  * \param[in]       parent: Parent widget where to check for touch
  * \return          Member of \ref guii_touch_status_t enumeration about success
@@ -474,6 +687,11 @@ process_touch(guii_touch_data_t* const touch, gui_touch_data_t* const touch_old,
             break;
         }
         
+        /* Ignore widget and its children when touch is not on widget */
+        if (!is_touch_inside_widget(touch, h)) {
+            continue;
+        }
+        
         /* Check for keyboard mode */
         if (h->id == GUI_ID_KEYBOARD_BASE) {
             isKeyboard = 1;                         /* Set keyboard mode as 1 */
@@ -637,6 +855,12 @@ gui_process_touch(void) {
                         GUI_EVT_RESULTTYPE_TOUCH(&result) = touchCONTINUE;
                         guii_widget_callback(GUI.active_widget, GUI_EVT_TOUCHSTART, &param, &result);    /* New amount of touch elements happened */
                     }
+                    if (GUI.active_widget != NULL) {
+                        gesture_move();             /* Recognize gestures */
+                        if (GUI.touch.gesture.flags & GESTURE_FLAG_HANDLED) {
+                            guii_widget_setflag(GUI.active_widget, GUI_FLAG_TOUCH_MOVE);    /* Gesture used touch, no click after release */
+                        }
+                    }
                 }
             }
             
@@ -647,9 +871,12 @@ gui_process_touch(void) {
              */
             if (GUI.touch.ts.status && !GUI.touch_old.status) {
                 process_touch(&GUI.touch, &GUI.touch_old, NULL);
-                if (GUI.active_widget != GUI.active_widget_prev) {  /* If new active widget is not the same as previous */
+                if (GUI.active_widget != GUI.active_widget_prev /* If new active widget is not the same as previous */
+                    || (GUI.touch.gesture.flags & GESTURE_FLAG_HANDLED)) {  /* or previous press was used by gesture */
                     PT_INIT(&GUI.touch.pt)          /* Reset thread, otherwise process with double click event */
                 }
+                GUI.touch.gesture.flags = 0;
+                gesture_start();                    /* Start gesture recognition */
             }
             
             /* Periodical check for events on active widget */
@@ -665,6 +892,7 @@ gui_process_touch(void) {
              */
             if (!GUI.touch.ts.status && GUI.touch_old.status) {
                 if (GUI.active_widget != NULL) {    /* Check if active widget */
+                    gesture_finish(1);              /* Finish gestures and detect fling */
                     GUI_EVT_PARAMTYPE_TOUCH(&param) = &GUI.touch;
                     GUI_EVT_RESULTTYPE_TOUCH(&result) = touchCONTINUE;
                     guii_widget_callback(GUI.active_widget, GUI_EVT_TOUCHEND, &param, &result);  /* Process callback function */
@@ -755,6 +983,7 @@ process_redraw(void) {
     }
     
     redraw_widgets(NULL, 0);                        /* Redraw all widgets now on drawing layer */
+    gui_mem_frame_reset();                          /* Release memory used during redraw */
     drawing->pending = 1;                           /* Set drawing layer as pending */
 
     /* Draw clipping area rectangle on screen for debug */
@@ -786,7 +1015,59 @@ default_event_cb(void) {
 
 }
 
+#if !GUI_CFG_OS
+static volatile uint8_t WakeupRequest;              /* Set to `1` by \ref gui_process_wakeup */
+#endif /* !GUI_CFG_OS */
+
+/**
+ * \brief           Get time GUI thread may sleep before processing is required again
+ * \return          Number of milliseconds, `0` if processing is already required
+ *                      or \ref GUI_TIMER_NO_DEADLINE when only new events require processing
+ */
+static uint32_t
+process_gettimeout(void) {
+    uint32_t timeout;
+#if GUI_CFG_USE_TOUCH
+    int32_t diff;
+#endif /* GUI_CFG_USE_TOUCH */
+
+    /* Check for work already pending */
+#if !GUI_CFG_OS
+    if (WakeupRequest) {
+        return 0;
+    }
+#endif /* !GUI_CFG_OS */
+    if ((GUI.flags & (GUI_FLAG_REMOVE | GUI_FLAG_LAYOUT_DIRTY))
+        || ((GUI.flags & GUI_FLAG_REDRAW) && !(GUI.lcd.flags & GUI_FLAG_LCD_WAIT_LAYER_CONFIRM))) {
+        return 0;
+    }
+#if GUI_CFG_USE_TOUCH
+    if (guii_input_touchavailable()) {
+        return 0;
+    }
+#endif /* GUI_CFG_USE_TOUCH */
+#if GUI_CFG_USE_KEYBOARD
+    if (guii_input_keyavailable()) {
+        return 0;
+    }
+#endif /* GUI_CFG_USE_KEYBOARD */
+
+    timeout = guii_timer_gettimeout();              /* Earliest timer expiration */
+#if GUI_CFG_USE_TOUCH
+    if (TouchWait) {                                /* Touch thread detects long and double clicks by time */
+        diff = (int32_t)(TouchWaitTime - gui_sys_now());
+        if (diff <= 0) {
+            timeout = 0;
+        } else if ((uint32_t)diff < timeout) {
+            timeout = (uint32_t)diff;
+        }
+    }
+#endif /* GUI_CFG_USE_TOUCH */
+    return timeout;
+}
+
 #if GUI_CFG_OS || __DOXYGEN__
+
 /**
  * \brief           GUI main thread for RTOS
  * \param[in]       argument: Pointer to user specific argument
@@ -871,18 +1152,31 @@ gui_init(void) {
  * \brief           Processes all drawing operations for GUI
  * \note            When `GUI_CFG_OS = 0`, user has to call this function in main loop,
  *                     otherwise it is processed in separated thread by GUI `GUI_CFG_OS != 0`
+ * \note            When `GUI_CFG_OS != 0`, function blocks until input is added, widget is modified
+ *                     from another thread, timer expires or \ref gui_process_wakeup is called
  * \return          Number of jobs done in current call
  */
 int32_t
 gui_process(void) {
-#if GUI_CFG_OS
+#if !GUI_CFG_OS
+    WakeupRequest = 0;                              /* Request is served by this call */
+#else /* !GUI_CFG_OS */
     gui_mbox_msg_t* msg;
-    uint32_t time;
-    uint32_t tmr_cnt = guii_timer_getactivecount(); /* Get number of active timers in system */
+    uint32_t timeout;
     
-    time = gui_sys_mbox_get(&GUI.OS.mbox, (void **)&msg, tmr_cnt ? 1 : 20); /* Get value from message queue */
+    GUI_CORE_PROTECT(1);
+    timeout = process_gettimeout();                 /* Sleep exactly until next deadline */
+    GUI_CORE_UNPROTECT(1);
+
+    /* Wait for new message or deadline, timeout `0` in message queue means waiting forever */
+    if (timeout == GUI_TIMER_NO_DEADLINE) {
+        gui_sys_mbox_get(&GUI.OS.mbox, (void **)&msg, 0);
+    } else if (timeout) {
+        gui_sys_mbox_get(&GUI.OS.mbox, (void **)&msg, timeout);
+    } else {
+        gui_sys_mbox_getnow(&GUI.OS.mbox, (void **)&msg);  /* Deadline expired, do not wait */
+    }
     
-    GUI_UNUSED(time);
     GUI_UNUSED(msg);
 #endif /* GUI_CFG_OS */
    
@@ -895,12 +1189,57 @@ gui_process(void) {
 #if GUI_CFG_USE_KEYBOARD
     process_keyboard();                             /* Process keyboard inputs */
 #endif /* GUI_CFG_USE_KEYBOARD */
+    guii_widget_executelayout();                    /* Arrange children of modified layouts */
+#if GUI_CFG_MEM_COMPACT
+    gui_mem_compact(GUI_CFG_MEM_COMPACT);           /* Merge free memory, bounded number of blocks per call */
+#endif /* GUI_CFG_MEM_COMPACT */
     process_redraw();                               /* Redraw widgets */
     GUI_CORE_UNPROTECT(1);
     
     return 0;                                       /* Return number of elements updated on GUI */
 }
 
+/**
+ * \brief           Get time until \ref gui_process must be called again
+ *
+ *                  Use this function in bare-metal applications (`GUI_CFG_OS = 0`) after \ref gui_process
+ *                  to decide how long CPU may stay in low-power mode. Touch and keyboard interrupts
+ *                  adding new input must wake up CPU regardless of returned time.
+ *
+ * \note            To not miss input added from interrupt between call to this function and entering low-power mode,
+ *                      call it with interrupts disabled and let low-power instruction enable them
+ * \return          Number of milliseconds, `0` if processing is required immediately
+ *                      or \ref GUI_TIMER_NO_DEADLINE when only new input or \ref gui_process_wakeup requires processing
+ */
+uint32_t
+gui_process_gettimeout(void) {
+    uint32_t timeout;
+
+    GUI_CORE_PROTECT(1);
+    timeout = process_gettimeout();
+    GUI_CORE_UNPROTECT(1);
+    return timeout;
+}
+
+/**
+ * \brief           Request processing of GUI without any other event
+ *
+ *                  When `GUI_CFG_OS != 0`, GUI thread waiting for events is woken up.
+ *                  When `GUI_CFG_OS = 0`, \ref gui_process_gettimeout returns `0` until \ref gui_process is called
+ *
+ * \note            Function may be called from interrupt or any thread
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_process_wakeup(void) {
+#if GUI_CFG_OS
+    return gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);
+#else /* GUI_CFG_OS */
+    WakeupRequest = 1;
+    return 1;
+#endif /* !GUI_CFG_OS */
+}
+
 /**
  * \brief           Set callback for global events from GUI
  * \param[in]       evt_fn: Callback function
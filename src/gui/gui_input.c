@@ -36,21 +36,135 @@
 #include "gui/gui_input.h"
 #include "system/gui_sys.h"
 
+/**
+ * \brief           Single producer single consumer ring of input entries
+ *
+ *                  Producer (interrupt or any thread) only writes `in` index and consumer (GUI thread)
+ *                  only writes `out` index, so no locking is required on either side.
+ *                  Indexes are free running, entry position is index masked with power of `2` size.
+ *                  Entries are stored in typed arrays and copied by caller between index functions
+ */
+typedef struct {
+    volatile uint32_t in;                           /*!< Index of next entry to write, written by producer */
+    volatile uint32_t out;                          /*!< Index of next entry to read, written by consumer */
+    volatile uint32_t overflow;                     /*!< Number of dropped entries */
+} input_ring_t;
+
+/* Round value up to power of 2 in compile time */
+#define INPUT_OR_SHIFT(x, s)        ((x) | ((x) >> (s)))
+#define INPUT_RING_SIZE(x)          (INPUT_OR_SHIFT(INPUT_OR_SHIFT(INPUT_OR_SHIFT(INPUT_OR_SHIFT(INPUT_OR_SHIFT((uint32_t)(x) - 1, 1), 2), 4), 8), 16) + 1)
+
 /* Define buffers */
 #if GUI_CFG_USE_TOUCH
-static gui_buff_t buff_ts;
-static uint8_t buff_ts_data[sizeof(gui_touch_data_t) * GUI_CFG_TOUCH_BUFFER_SIZE + 1];
+#define TS_SIZE                     INPUT_RING_SIZE(GUI_CFG_TOUCH_BUFFER_SIZE)
+static input_ring_t ring_ts;
+static gui_touch_data_t ring_ts_data[TS_SIZE];
+static gui_touch_state_t ts_last_status;            /* Status of last entry read from buffer */
+static uint8_t ts_last_count;                       /* Number of touches of last entry read from buffer */
+#if GUI_CFG_TOUCH_HISTORY
+static gui_touch_point_t ts_history[GUI_CFG_TOUCH_MAX_PRESSES][GUI_CFG_TOUCH_HISTORY];
+static size_t ts_history_index, ts_history_count;
+static uint8_t ts_history_touches;                  /* Number of touches in history */
+#endif /* GUI_CFG_TOUCH_HISTORY */
 #endif /* GUI_CFG_USE_TOUCH */
 
 #if GUI_CFG_USE_KEYBOARD
-static gui_buff_t buff_kb;
-static uint8_t buff_kb_data[sizeof(gui_keyboard_data_t) * GUI_CFG_KEYBOARD_BUFFER_SIZE *  + 1];
+#define KB_SIZE                     INPUT_RING_SIZE(GUI_CFG_KEYBOARD_BUFFER_SIZE)
+static input_ring_t ring_kb;
+static gui_keyboard_data_t ring_kb_data[KB_SIZE];
 #endif /* GUI_CFG_USE_KEYBOARD */
 
+#if GUI_CFG_USE_TOUCH || GUI_CFG_USE_KEYBOARD
+
+/**
+ * \brief           Check if producer may write entry at `in` index
+ * \note            Called by producer only
+ * \param[in]       r: Input ring
+ * \param[in]       size: Number of entries in ring
+ * \return          `1` if entry may be written, `0` if entry is dropped
+ */
+static uint8_t
+ring_canwrite(input_ring_t* r, uint32_t size) {
+#if GUI_CFG_INPUT_DROP_OLDEST
+    GUI_UNUSED2(r, size);                           /* Oldest entry is overwritten, consumer detects it */
+#else /* GUI_CFG_INPUT_DROP_OLDEST */
+    if (r->in - r->out >= size) {                   /* Ring is full, drop new entry */
+        r->overflow++;
+        return 0;
+    }
+#endif /* !GUI_CFG_INPUT_DROP_OLDEST */
+    return 1;
+}
+
+/**
+ * \brief           Publish entry written at `in` index to consumer
+ * \note            Called by producer only
+ * \param[in]       r: Input ring
+ */
+static void
+ring_writedone(input_ring_t* r) {
+    GUI_CFG_MEMORY_BARRIER();                       /* Entry must be written before index */
+    r->in = r->in + 1;
+}
+
+/**
+ * \brief           Get number of entries available to consumer
+ *
+ *                  When oldest entries were overwritten by producer,
+ *                  `out` index is moved to oldest valid entry first
+ *
+ * \note            Called by consumer only
+ * \param[in]       r: Input ring
+ * \param[in]       size: Number of entries in ring
+ * \return          Number of entries to read
+ */
+static uint32_t
+ring_getfull(input_ring_t* r, uint32_t size) {
+    uint32_t in = r->in, full;
+
+    GUI_CFG_MEMORY_BARRIER();                       /* Read index before entries */
+    full = in - r->out;
+#if GUI_CFG_INPUT_DROP_OLDEST
+    if (full >= size) {                             /* Entry at `out` is overwritten or being overwritten */
+        r->overflow += full - size + 1;
+        r->out = in - size + 1;
+        full = size - 1;
+    }
+#else /* GUI_CFG_INPUT_DROP_OLDEST */
+    GUI_UNUSED(size);
+#endif /* !GUI_CFG_INPUT_DROP_OLDEST */
+    return full;
+}
+
+/**
+ * \brief           Finish reading of entry at `out` index
+ * \note            Called by consumer only
+ * \param[in]       r: Input ring
+ * \param[in]       size: Number of entries in ring
+ * \return          `1` if entry was read, `0` if producer overwrote entry during copy and entry must be read again
+ */
+static uint8_t
+ring_readdone(input_ring_t* r, uint32_t size) {
+    GUI_CFG_MEMORY_BARRIER();                       /* Entry must be copied before index check */
+#if GUI_CFG_INPUT_DROP_OLDEST
+    if (r->in - r->out >= size) {                   /* Producer reached entry while copying it */
+        return 0;
+    }
+#else /* GUI_CFG_INPUT_DROP_OLDEST */
+    GUI_UNUSED(size);
+#endif /* !GUI_CFG_INPUT_DROP_OLDEST */
+    r->out = r->out + 1;
+    return 1;
+}
+
+#endif /* GUI_CFG_USE_TOUCH || GUI_CFG_USE_KEYBOARD */
+
 #if GUI_CFG_USE_TOUCH || __DOXYGEN__
 
 /**
  * \brief           Add new touch data to internal buffer for further processing
+ * \note            Function is wait-free and may be called from interrupt,
+ *                      but only from one producer at a time
  * \param[in]       ts: Pointer to \ref gui_touch_data_t touch data with valid input
  * \return          `1` on success, `0` otherwise
  */
@@ -60,7 +174,11 @@ gui_input_touchadd(gui_touch_data_t* const ts) {
     GUI_ASSERTPARAMS(ts);
     
     ts->time = gui_sys_now();                       /* Set event time */
-    ret = gui_buffer_write(&buff_ts, ts, sizeof(*ts)) ? 1 : 0;  /* Write data to buffer */
+    ret = ring_canwrite(&ring_ts, TS_SIZE);
+    if (ret) {
+        ring_ts_data[ring_ts.in & (TS_SIZE - 1)] = *ts; /* Write data to buffer */
+        ring_writedone(&ring_ts);
+    }
     
 #if GUI_CFG_OS
     gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);        /* Notify stack about new key added */
@@ -68,18 +186,118 @@ gui_input_touchadd(gui_touch_data_t* const ts) {
     return ret;
 }
 
+/**
+ * \brief           Get number of touch entries dropped because input buffer was full
+ * \return          Number of dropped entries since initialization
+ */
+uint32_t
+gui_input_touchgetoverflow(void) {
+    return ring_ts.overflow;
+}
+
+/**
+ * \brief           Add touch entry to history of current press
+ * \param[in]       ts: Touch entry read from buffer
+ */
+static void
+touch_history_add(const gui_touch_data_t* ts) {
+#if GUI_CFG_TOUCH_HISTORY
+    uint8_t i;
+
+    if (ts->status && ts->count) {
+        if (!ts_last_status || ts->count != ts_last_count) {    /* New press or number of touches starts new history */
+            ts_history_count = 0;
+            ts_history_touches = ts->count;
+        }
+        for (i = 0; i < ts->count && i < GUI_CFG_TOUCH_MAX_PRESSES; i++) {
+            ts_history[i][ts_history_index].x = ts->x[i];
+            ts_history[i][ts_history_index].y = ts->y[i];
+            ts_history[i][ts_history_index].time = ts->time;
+        }
+        if (++ts_history_index == GUI_CFG_TOUCH_HISTORY) {
+            ts_history_index = 0;
+        }
+        if (ts_history_count < GUI_CFG_TOUCH_HISTORY) {
+            ts_history_count++;
+        }
+    }
+#else /* GUI_CFG_TOUCH_HISTORY */
+    GUI_UNUSED(ts);
+#endif /* !GUI_CFG_TOUCH_HISTORY */
+}
+
 /**
  * \brief           Reads new touch entry
+ *
+ *                  When \ref GUI_CFG_TOUCH_COALESCE is enabled and entry is touch move,
+ *                  all following move entries with the same number of touches are merged into the latest one
+ *
  * \param[out]      ts: Pointer to \ref gui_touch_data_t structure to save touch into to
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 guii_input_touchread(gui_touch_data_t* const ts) {
-    if (gui_buffer_getfull(&buff_ts) >= sizeof(*ts)) {
-        gui_buffer_read(&buff_ts, ts, sizeof(*ts)); /* Read data from buffer */
-        return 1;
+#if GUI_CFG_TOUCH_COALESCE
+    gui_touch_data_t next;
+#endif /* GUI_CFG_TOUCH_COALESCE */
+
+    do {
+        if (!ring_getfull(&ring_ts, TS_SIZE)) {
+            return 0;
+        }
+        *ts = ring_ts_data[ring_ts.out & (TS_SIZE - 1)];    /* Read data from buffer */
+    } while (!ring_readdone(&ring_ts, TS_SIZE));
+    touch_history_add(ts);
+#if GUI_CFG_TOUCH_COALESCE
+    if (ts->status && ts_last_status && ts->count == ts_last_count) {   /* Touch move entry */
+        while (ring_getfull(&ring_ts, TS_SIZE)) {
+            next = ring_ts_data[ring_ts.out & (TS_SIZE - 1)];
+            if (!next.status || next.count != ts->count) {
+                break;                              /* Keep press and release entries */
+            }
+            if (ring_readdone(&ring_ts, TS_SIZE)) {
+                *ts = next;                         /* Replace with newer move entry */
+                touch_history_add(ts);
+            }
+        }
+    }
+#endif /* GUI_CFG_TOUCH_COALESCE */
+    ts_last_status = ts->status;
+    ts_last_count = ts->count;
+    return 1;
+}
+
+/**
+ * \brief           Get touch points of current or last press
+ * \note            History is restarted when number of touches changes
+ * \param[in]       touch: Touch index, from `0` to number of touches - `1`
+ * \param[out]      points: Array to save points to, from oldest to latest
+ * \param[in]       count: Maximal number of points to save
+ * \return          Number of points saved to array
+ */
+size_t
+guii_input_touchgethistory(uint8_t touch, gui_touch_point_t* const points, size_t count) {
+#if GUI_CFG_TOUCH_HISTORY
+    size_t i, index;
+
+    if (touch >= GUI_CFG_TOUCH_MAX_PRESSES || touch >= ts_history_touches) {
+        return 0;
+    }
+    if (count > ts_history_count) {
+        count = ts_history_count;
     }
+    index = (ts_history_index + GUI_CFG_TOUCH_HISTORY - count) % GUI_CFG_TOUCH_HISTORY;
+    for (i = 0; i < count; i++) {
+        points[i] = ts_history[touch][index];
+        if (++index == GUI_CFG_TOUCH_HISTORY) {
+            index = 0;
+        }
+    }
+    return count;
+#else /* GUI_CFG_TOUCH_HISTORY */
+    GUI_UNUSED3(touch, points, count);
     return 0;
+#endif /* !GUI_CFG_TOUCH_HISTORY */
 }
 
 /**
@@ -88,7 +306,7 @@ guii_input_touchread(gui_touch_data_t* const ts) {
  */
 uint8_t
 guii_input_touchavailable(void) {
-    return gui_buffer_getfull(&buff_ts) > 0;       /* Check if any available touch */
+    return ring_getfull(&ring_ts, TS_SIZE) > 0;     /* Check if any available touch */
 }
 
 #endif /* GUI_CFG_USE_TOUCH || __DOXYGEN__ */
@@ -97,6 +315,8 @@ guii_input_touchavailable(void) {
 
 /**
  * \brief           Add new key data to internal buffer for further processing
+ * \note            Function is wait-free and may be called from interrupt,
+ *                      but only from one producer at a time
  * \param[in]       kb: Pointer to \ref gui_keyboard_data_t key data
  * \return          `1` on success, `0` otherwise
  */
@@ -105,7 +325,11 @@ gui_input_keyadd(gui_keyboard_data_t* const kb) {
     uint8_t ret;
     GUI_ASSERTPARAMS(kb);
     kb->time = gui_sys_now();                       /* Set event time */
-    ret = gui_buffer_write(&buff_kb, kb, sizeof(*kb)) ? 1 : 0; /* Write data to buffer */
+    ret = ring_canwrite(&ring_kb, KB_SIZE);
+    if (ret) {
+        ring_kb_data[ring_kb.in & (KB_SIZE - 1)] = *kb; /* Write data to buffer */
+        ring_writedone(&ring_kb);
+    }
     
 #if GUI_CFG_OS
     gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);        /* Notify stack about new key added */
@@ -113,6 +337,15 @@ gui_input_keyadd(gui_keyboard_data_t* const kb) {
     return ret;
 }
 
+/**
+ * \brief           Get number of keyboard entries dropped because input buffer was full
+ * \return          Number of dropped entries since initialization
+ */
+uint32_t
+gui_input_keygetoverflow(void) {
+    return ring_kb.overflow;
+}
+
 /**
  * \brief           Read keyboard entry from buffer
  * \param[out]      kb: Pointer to \ref gui_keyboard_data_t to save entry to
@@ -120,11 +353,22 @@ gui_input_keyadd(gui_keyboard_data_t* const kb) {
  */
 uint8_t
 guii_input_keyread(gui_keyboard_data_t* const kb) {
-    if (gui_buffer_getfull(&buff_kb) >= sizeof(*kb)) {
-        gui_buffer_read(&buff_kb, kb, sizeof(*kb)); /* Read data from buffer */
-        return 1;
-    }
-    return 0;
+    do {
+        if (!ring_getfull(&ring_kb, KB_SIZE)) {
+            return 0;
+        }
+        *kb = ring_kb_data[ring_kb.out & (KB_SIZE - 1)];    /* Read data from buffer */
+    } while (!ring_readdone(&ring_kb, KB_SIZE));
+    return 1;
+}
+
+/**
+ * \brief           Checks if anything available for keyboard inputs
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_input_keyavailable(void) {
+    return ring_getfull(&ring_kb, KB_SIZE) > 0;     /* Check if any available key */
 }
 #endif /* GUI_CFG_USE_KEYBOARD || __DOXYGEN__ */
 
@@ -134,9 +378,9 @@ guii_input_keyread(gui_keyboard_data_t* const kb) {
 void
 guii_input_init(void) {
 #if GUI_CFG_USE_TOUCH
-    gui_buffer_init(&buff_ts, sizeof(buff_ts_data), buff_ts_data);
+    memset((void *)&ring_ts, 0x00, sizeof(ring_ts));
 #endif /* GUI_CFG_USE_TOUCH */
 #if GUI_CFG_USE_KEYBOARD
-    gui_buffer_init(&buff_kb, sizeof(buff_kb_data), buff_kb_data);
+    memset((void *)&ring_kb, 0x00, sizeof(ring_kb));
 #endif /* GUI_CFG_USE_KEYBOARD */
 }
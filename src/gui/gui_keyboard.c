@@ -42,23 +42,9 @@
 typedef struct {
     uint32_t c;                                     /*!< Character to print */
     uint32_t cs;                                    /*!< Character on shift */
-    float x;                                        /*!< Start X position */
-    float w;                                        /*!< Character width */
     uint8_t s;                                      /*!< Special function */
 } key_btn_t;
 
-typedef struct {
-    gui_dim_t x_offset;                             /*!< Starting X offset */
-    const key_btn_t* btns;                          /*!< Pointer to buttons structure */
-    size_t btns_count;                              /*!< Number of buttons in array */
-} key_row_t;
-
-typedef struct {
-    const key_row_t* rows;                          /*!< Pointer to rows objects */
-    size_t rows_count;                              /*!< Number of rows */
-    gui_id_t id;                                    /*!< Layout ID */
-} key_layout_t;
-
 typedef struct {
     uint8_t is_shift;                               /*!< Status indicating shift mode is enabled */
     gui_handle_p handle;                            /*!< Pointer to keyboard handle */
@@ -91,194 +77,161 @@ typedef struct {
 #define ACTION_HIDE                     0x01
 #define ACTION_SHOW                     0x02
 
-#define KEY_ROW(c_v, cs_v, x_v, w_v, s_v)         { .c = ((uint32_t)(c_v)), .cs = ((uint32_t)(cs_v)), .x = x_v, .w = w_v, .s = (s_v) }
+#define KEY_FLAGS                       (GUI_FLAG_WIDGET_TREE_XPOS_PERCENT | GUI_FLAG_WIDGET_TREE_YPOS_PERCENT | \
+                                            GUI_FLAG_WIDGET_TREE_WIDTH_PERCENT | GUI_FLAG_WIDGET_TREE_HEIGHT_PERCENT)
 
-/***************************/
-/*   Layout 1 descriptors  */
-/***************************/
-static const key_btn_t
-buttons_l1_r1[] = {
-    KEY_ROW('q', 'Q', 0.5f,  9.0f, 0),
-    KEY_ROW('w', 'W', 10.5f, 9.0f, 0),
-    KEY_ROW('e', 'E', 20.5f, 9.0f, 0),
-    KEY_ROW('r', 'R', 30.5f, 9.0f, 0),
-    KEY_ROW('t', 'T', 40.5f, 9.0f, 0),
-    KEY_ROW('z', 'Z', 50.5f, 9.0f, 0),
-    KEY_ROW('u', 'U', 60.5f, 9.0f, 0),
-    KEY_ROW('i', 'I', 70.5f, 9.0f, 0),
-    KEY_ROW('o', 'O', 80.5f, 9.0f, 0),
-    KEY_ROW('p', 'P', 90.5f, 9.0f, 0),
-};
+/* Key button node, where `r_v` is row index and `z_v` is z-index of button in row */
+#define KEY(c_v, cs_v, x_v, w_v, s_v, r_v, z_v)   { .create = gui_button_create, .x = (x_v), .y = (1.0f + 25.0f * (r_v)), \
+                                                    .width = (w_v), .height = 23.0f, .tree_flags = KEY_FLAGS, \
+                                                    .zindex = (z_v), .callback = keyboard_btn_callback, \
+                                                    .arg = (void *)&(const key_btn_t){ .c = ((uint32_t)(c_v)), .cs = ((uint32_t)(cs_v)), .s = (s_v) } }
 
-static const key_btn_t
-buttons_l1_r2[] = {
-    KEY_ROW('a', 'A', 5.5f, 9.0f, 0),
-    KEY_ROW('s', 'S', 15.5f, 9.0f, 0),
-    KEY_ROW('d', 'D', 25.5f, 9.0f, 0),
-    KEY_ROW('f', 'F', 35.5f, 9.0f, 0),
-    KEY_ROW('g', 'G', 45.5f, 9.0f, 0),
-    KEY_ROW('h', 'H', 55.5f, 9.0f, 0),
-    KEY_ROW('j', 'J', 65.5f, 9.0f, 0),
-    KEY_ROW('k', 'K', 75.5f, 9.0f, 0),
-    KEY_ROW('l', 'L', 85.5f, 9.0f, 0),
-};
+/* Keyboard layout node on bottom half of keyboard */
+#define KEY_LAYOUT(id_v, keys_v, f_v)   { .create = gui_container_create, .id = (id_v), .x = 0.0f, .y = 50.0f, .width = 100.0f, .height = 50.0f, \
+                                            .tree_flags = KEY_FLAGS | (f_v), .callback = keyboard_callback, \
+                                            .children = (keys_v), .children_count = GUI_COUNT_OF(keys_v) }
 
-static const key_btn_t
-buttons_l1_r3[] = {
-    KEY_ROW(0, 0, 0.5f, 14.0f, SPECIAL_SHIFT),
-    KEY_ROW('y', 'Y', 15.5f, 9.0f, 0),
-    KEY_ROW('x', 'X', 25.5f, 9.0f, 0),
-    KEY_ROW('c', 'C', 35.5f, 9.0f, 0),
-    KEY_ROW('v', 'V', 45.5f, 9.0f, 0),
-    KEY_ROW('b', 'B', 55.5f, 9.0f, 0),
-    KEY_ROW('n', 'N', 65.5f, 9.0f, 0),
-    KEY_ROW('m', 'M', 75.5f, 9.0f, 0),
-    KEY_ROW(0, 0, 85.5f, 14.0f, SPECIAL_BACKSPACE),
-};
+static uint8_t keyboard_btn_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const param, gui_evt_result_t* const result);
+static uint8_t keyboard_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const param, gui_evt_result_t* const result);
 
-static const key_btn_t
-buttons_l1_r4[] = {
-    KEY_ROW(0, 0, 0.5f, 9.0f, SPECIAL_123),
-    KEY_ROW(' ', 0, 10.5f, 59.0f, 0),
-    KEY_ROW('.', 0, 70.5f, 9.0f, 0),
-    KEY_ROW(0, 0, 80.5f, 9.0f, SPECIAL_ENTER),
-    KEY_ROW(0, 0, 90.5f, 9.0f, SPECIAL_HIDE),
-};
-
-static const key_row_t
-keyboard_rows_l1[] = {
-    {.x_offset = 1, .btns = buttons_l1_r1, .btns_count = GUI_COUNT_OF(buttons_l1_r1)},
-    {.x_offset = 1, .btns = buttons_l1_r2, .btns_count = GUI_COUNT_OF(buttons_l1_r2)},
-    {.x_offset = 1, .btns = buttons_l1_r3, .btns_count = GUI_COUNT_OF(buttons_l1_r3)},
-    {.x_offset = 1, .btns = buttons_l1_r4, .btns_count = GUI_COUNT_OF(buttons_l1_r4)},
-};
-                
 /***************************/
-/*   Layout 2 descriptors  */
+/*   Layout 1 descriptors  */
 /***************************/
-static const key_btn_t
-buttons_l2_r1[] = {
-    KEY_ROW('1', 0, 0.5f, 9.0f, 0),
-    KEY_ROW('2', 0, 10.5f, 9.0f, 0),
-    KEY_ROW('3', 0, 20.5f, 9.0f, 0),
-    KEY_ROW('4', 0, 30.5f, 9.0f, 0),
-    KEY_ROW('5', 0, 40.5f, 9.0f, 0),
-    KEY_ROW('6', 0, 50.5f, 9.0f, 0),
-    KEY_ROW('7', 0, 60.5f, 9.0f, 0),
-    KEY_ROW('8', 0, 70.5f, 9.0f, 0),
-    KEY_ROW('9', 0, 80.5f, 9.0f, 0),
-    KEY_ROW('0', 0, 90.5f, 9.0f, 0),
-};
-
-static const key_btn_t
-buttons_l2_r2[] = {
-    KEY_ROW('-', 0, 0.5f, 9.0f, 0),
-    KEY_ROW('/', 0, 10.5f, 9.0f, 0),
-    KEY_ROW(':', 0, 20.5f, 9.0f, 0),
-    KEY_ROW(';', 0, 30.5f, 9.0f, 0),
-    KEY_ROW('(', 0, 40.5f, 9.0f, 0),
-    KEY_ROW(')', 0, 50.5f, 9.0f, 0),
-    KEY_ROW('$', 0, 60.5f, 9.0f, 0),
-    KEY_ROW('&', 0, 70.5f, 9.0f, 0),
-    KEY_ROW('@', 0, 80.5f, 9.0f, 0),
-    KEY_ROW('"', 0, 90.5f, 9.0f, 0),
-};
-
-static const key_btn_t
-buttons_l2_r3[] = {
-    KEY_ROW(0, 0, 0.5f, 14.0f, SPECIAL_CALC),
-    KEY_ROW('.', 0, 15.5f, 13.0f, 0),
-    KEY_ROW(',', 0, 29.5f, 13.0f, 0),
-    KEY_ROW('?', 0, 43.5f, 13.0f, 0),
-    KEY_ROW('!', 0, 57.5f, 13.0f, 0),
-    KEY_ROW('\'', 0, 71.5f, 13.0f, 0),
-    KEY_ROW(0, 0, 85.5f, 14.0f, SPECIAL_BACKSPACE),
-};
-
-static const key_btn_t
-buttons_l2_r4[] = {
-    {.c = 0, .x = 0.5, .w = 9, .s = ((uint32_t)SPECIAL_ABC)},
-    {.c = ((uint32_t)' '), .x = 10.5, .w = 59},
-    {.c = ((uint32_t)'.'), .x = 70.5, .w = 9},
-    {.c = 0, .x = 80.5, .w = 9, .s = ((uint32_t)SPECIAL_ENTER)},
-    {.c = 0, .x = 90.5, .w = 9, .s = ((uint32_t)SPECIAL_HIDE)},
-};
-
-static const key_row_t
-keyboard_rows_l2[] = {
-    {.x_offset = 1, .btns = buttons_l2_r1, .btns_count = GUI_COUNT_OF(buttons_l2_r1)},
-    {.x_offset = 1, .btns = buttons_l2_r2, .btns_count = GUI_COUNT_OF(buttons_l2_r2)},
-    {.x_offset = 1, .btns = buttons_l2_r3, .btns_count = GUI_COUNT_OF(buttons_l2_r3)},
-    {.x_offset = 1, .btns = buttons_l2_r4, .btns_count = GUI_COUNT_OF(buttons_l2_r4)},
+static const gui_widget_tree_t
+keys_l1[] = {
+    /* Row 1 */
+    KEY('q', 'Q', 0.5f, 9.0f, 0, 0, 0),
+    KEY('w', 'W', 10.5f, 9.0f, 0, 0, 1),
+    KEY('e', 'E', 20.5f, 9.0f, 0, 0, 2),
+    KEY('r', 'R', 30.5f, 9.0f, 0, 0, 3),
+    KEY('t', 'T', 40.5f, 9.0f, 0, 0, 4),
+    KEY('z', 'Z', 50.5f, 9.0f, 0, 0, 5),
+    KEY('u', 'U', 60.5f, 9.0f, 0, 0, 6),
+    KEY('i', 'I', 70.5f, 9.0f, 0, 0, 7),
+    KEY('o', 'O', 80.5f, 9.0f, 0, 0, 8),
+    KEY('p', 'P', 90.5f, 9.0f, 0, 0, 9),
+    /* Row 2 */
+    KEY('a', 'A', 5.5f, 9.0f, 0, 1, 0),
+    KEY('s', 'S', 15.5f, 9.0f, 0, 1, 1),
+    KEY('d', 'D', 25.5f, 9.0f, 0, 1, 2),
+    KEY('f', 'F', 35.5f, 9.0f, 0, 1, 3),
+    KEY('g', 'G', 45.5f, 9.0f, 0, 1, 4),
+    KEY('h', 'H', 55.5f, 9.0f, 0, 1, 5),
+    KEY('j', 'J', 65.5f, 9.0f, 0, 1, 6),
+    KEY('k', 'K', 75.5f, 9.0f, 0, 1, 7),
+    KEY('l', 'L', 85.5f, 9.0f, 0, 1, 8),
+    /* Row 3 */
+    KEY(0, 0, 0.5f, 14.0f, SPECIAL_SHIFT, 2, 0),
+    KEY('y', 'Y', 15.5f, 9.0f, 0, 2, 1),
+    KEY('x', 'X', 25.5f, 9.0f, 0, 2, 2),
+    KEY('c', 'C', 35.5f, 9.0f, 0, 2, 3),
+    KEY('v', 'V', 45.5f, 9.0f, 0, 2, 4),
+    KEY('b', 'B', 55.5f, 9.0f, 0, 2, 5),
+    KEY('n', 'N', 65.5f, 9.0f, 0, 2, 6),
+    KEY('m', 'M', 75.5f, 9.0f, 0, 2, 7),
+    KEY(0, 0, 85.5f, 14.0f, SPECIAL_BACKSPACE, 2, 8),
+    /* Row 4 */
+    KEY(0, 0, 0.5f, 9.0f, SPECIAL_123, 3, 0),
+    KEY(' ', 0, 10.5f, 59.0f, 0, 3, 1),
+    KEY('.', 0, 70.5f, 9.0f, 0, 3, 2),
+    KEY(0, 0, 80.5f, 9.0f, SPECIAL_ENTER, 3, 3),
+    KEY(0, 0, 90.5f, 9.0f, SPECIAL_HIDE, 3, 4),
 };
 
 /***************************/
 /*   Layout 2 descriptors  */
 /***************************/
-static const key_btn_t
-buttons_l3_r1[] = {
-    {.c = ((uint32_t)'['), .x = 0.5, .w = 9},
-    {.c = ((uint32_t)']'), .x = 10.5, .w = 9},
-    {.c = ((uint32_t)'{'), .x = 20.5, .w = 9},
-    {.c = ((uint32_t)'}'), .x = 30.5, .w = 9},
-    {.c = ((uint32_t)'#'), .x = 40.5, .w = 9},
-    {.c = ((uint32_t)'%'), .x = 50.5, .w = 9},
-    {.c = ((uint32_t)'^'), .x = 60.5, .w = 9},
-    {.c = ((uint32_t)'*'), .x = 70.5, .w = 9},
-    {.c = ((uint32_t)'+'), .x = 80.5, .w = 9},
-    {.c = ((uint32_t)'='), .x = 90.5, .w = 9}
-};
-
-static const key_btn_t
-buttons_l3_r2[] = {
-    {.c = ((uint32_t)'_'), .x = 0.5, .w = 9},
-    {.c = ((uint32_t)'\\'), .x = 10.5, .w = 9},
-    {.c = ((uint32_t)'|'), .x = 20.5, .w = 9},
-    {.c = ((uint32_t)'~'), .x = 30.5, .w = 9},
-    {.c = ((uint32_t)'<'), .x = 40.5, .w = 9},
-    {.c = ((uint32_t)'>'), .x = 50.5, .w = 9},
-    {.c = ((uint32_t)'$'), .x = 60.5, .w = 9},
-    {.c = ((uint32_t)':'), .x = 70.5, .w = 9},
-    {.c = ((uint32_t)';'), .x = 80.5, .w = 9},
-    {.c = ((uint32_t)'-'), .x = 90.5, .w = 9}
+static const gui_widget_tree_t
+keys_l2[] = {
+    /* Row 1 */
+    KEY('1', 0, 0.5f, 9.0f, 0, 0, 0),
+    KEY('2', 0, 10.5f, 9.0f, 0, 0, 1),
+    KEY('3', 0, 20.5f, 9.0f, 0, 0, 2),
+    KEY('4', 0, 30.5f, 9.0f, 0, 0, 3),
+    KEY('5', 0, 40.5f, 9.0f, 0, 0, 4),
+    KEY('6', 0, 50.5f, 9.0f, 0, 0, 5),
+    KEY('7', 0, 60.5f, 9.0f, 0, 0, 6),
+    KEY('8', 0, 70.5f, 9.0f, 0, 0, 7),
+    KEY('9', 0, 80.5f, 9.0f, 0, 0, 8),
+    KEY('0', 0, 90.5f, 9.0f, 0, 0, 9),
+    /* Row 2 */
+    KEY('-', 0, 0.5f, 9.0f, 0, 1, 0),
+    KEY('/', 0, 10.5f, 9.0f, 0, 1, 1),
+    KEY(':', 0, 20.5f, 9.0f, 0, 1, 2),
+    KEY(';', 0, 30.5f, 9.0f, 0, 1, 3),
+    KEY('(', 0, 40.5f, 9.0f, 0, 1, 4),
+    KEY(')', 0, 50.5f, 9.0f, 0, 1, 5),
+    KEY('$', 0, 60.5f, 9.0f, 0, 1, 6),
+    KEY('&', 0, 70.5f, 9.0f, 0, 1, 7),
+    KEY('@', 0, 80.5f, 9.0f, 0, 1, 8),
+    KEY('"', 0, 90.5f, 9.0f, 0, 1, 9),
+    /* Row 3 */
+    KEY(0, 0, 0.5f, 14.0f, SPECIAL_CALC, 2, 0),
+    KEY('.', 0, 15.5f, 13.0f, 0, 2, 1),
+    KEY(',', 0, 29.5f, 13.0f, 0, 2, 2),
+    KEY('?', 0, 43.5f, 13.0f, 0, 2, 3),
+    KEY('!', 0, 57.5f, 13.0f, 0, 2, 4),
+    KEY('\'', 0, 71.5f, 13.0f, 0, 2, 5),
+    KEY(0, 0, 85.5f, 14.0f, SPECIAL_BACKSPACE, 2, 6),
+    /* Row 4 */
+    KEY(0, 0, 0.5f, 9.0f, SPECIAL_ABC, 3, 0),
+    KEY(' ', 0, 10.5f, 59.0f, 0, 3, 1),
+    KEY('.', 0, 70.5f, 9.0f, 0, 3, 2),
+    KEY(0, 0, 80.5f, 9.0f, SPECIAL_ENTER, 3, 3),
+    KEY(0, 0, 90.5f, 9.0f, SPECIAL_HIDE, 3, 4),
 };
 
-static const key_btn_t
-buttons_l3_r3[] = {
-    {.c = 0, .x = 0.5, .w = 14, .s = SPECIAL_123},
-    {.c = ((uint32_t)'.'), .x = 15.5, .w = 13},
-    {.c = ((uint32_t)','), .x = 29.5, .w = 13},
-    {.c = ((uint32_t)'?'), .x = 43.5, .w = 13},
-    {.c = ((uint32_t)'!'), .x = 57.5, .w = 13},
-    {.c = ((uint32_t)'\''), .x = 71.5, .w = 13},
-    {.c = 0, .x = 85.5, .w = 14, .s = SPECIAL_BACKSPACE},
-};
-
-static const key_btn_t
-buttons_l3_r4[] = {
-    {.c = 0, .x = 0.5, .w = 9, .s = ((uint32_t)SPECIAL_ABC)},
-    {.c = ((uint32_t)' '), .x = 10.5, .w = 59},
-    {.c = ((uint32_t)'.'), .x = 70.5, .w = 9},
-    {.c = 0, .x = 80.5, .w = 9, .s = ((uint32_t)SPECIAL_ENTER)},
-    {.c = 0, .x = 90.5, .w = 9, .s = ((uint32_t)SPECIAL_HIDE)},
-};
-
-static const key_row_t
-keyboard_rows_l3[] = {
-    {.x_offset = 1, .btns = buttons_l3_r1, .btns_count = GUI_COUNT_OF(buttons_l3_r1)},
-    {.x_offset = 1, .btns = buttons_l3_r2, .btns_count = GUI_COUNT_OF(buttons_l3_r2)},
-    {.x_offset = 1, .btns = buttons_l3_r3, .btns_count = GUI_COUNT_OF(buttons_l3_r3)},
-    {.x_offset = 1, .btns = buttons_l3_r4, .btns_count = GUI_COUNT_OF(buttons_l3_r4)},
+/***************************/
+/*   Layout 3 descriptors  */
+/***************************/
+static const gui_widget_tree_t
+keys_l3[] = {
+    /* Row 1 */
+    KEY('[', 0, 0.5f, 9.0f, 0, 0, 0),
+    KEY(']', 0, 10.5f, 9.0f, 0, 0, 1),
+    KEY('{', 0, 20.5f, 9.0f, 0, 0, 2),
+    KEY('}', 0, 30.5f, 9.0f, 0, 0, 3),
+    KEY('#', 0, 40.5f, 9.0f, 0, 0, 4),
+    KEY('%', 0, 50.5f, 9.0f, 0, 0, 5),
+    KEY('^', 0, 60.5f, 9.0f, 0, 0, 6),
+    KEY('*', 0, 70.5f, 9.0f, 0, 0, 7),
+    KEY('+', 0, 80.5f, 9.0f, 0, 0, 8),
+    KEY('=', 0, 90.5f, 9.0f, 0, 0, 9),
+    /* Row 2 */
+    KEY('_', 0, 0.5f, 9.0f, 0, 1, 0),
+    KEY('\\', 0, 10.5f, 9.0f, 0, 1, 1),
+    KEY('|', 0, 20.5f, 9.0f, 0, 1, 2),
+    KEY('~', 0, 30.5f, 9.0f, 0, 1, 3),
+    KEY('<', 0, 40.5f, 9.0f, 0, 1, 4),
+    KEY('>', 0, 50.5f, 9.0f, 0, 1, 5),
+    KEY('$', 0, 60.5f, 9.0f, 0, 1, 6),
+    KEY(':', 0, 70.5f, 9.0f, 0, 1, 7),
+    KEY(';', 0, 80.5f, 9.0f, 0, 1, 8),
+    KEY('-', 0, 90.5f, 9.0f, 0, 1, 9),
+    /* Row 3 */
+    KEY(0, 0, 0.5f, 14.0f, SPECIAL_123, 2, 0),
+    KEY('.', 0, 15.5f, 13.0f, 0, 2, 1),
+    KEY(',', 0, 29.5f, 13.0f, 0, 2, 2),
+    KEY('?', 0, 43.5f, 13.0f, 0, 2, 3),
+    KEY('!', 0, 57.5f, 13.0f, 0, 2, 4),
+    KEY('\'', 0, 71.5f, 13.0f, 0, 2, 5),
+    KEY(0, 0, 85.5f, 14.0f, SPECIAL_BACKSPACE, 2, 6),
+    /* Row 4 */
+    KEY(0, 0, 0.5f, 9.0f, SPECIAL_ABC, 3, 0),
+    KEY(' ', 0, 10.5f, 59.0f, 0, 3, 1),
+    KEY('.', 0, 70.5f, 9.0f, 0, 3, 2),
+    KEY(0, 0, 80.5f, 9.0f, SPECIAL_ENTER, 3, 3),
+    KEY(0, 0, 90.5f, 9.0f, SPECIAL_HIDE, 3, 4),
 };
 
 /************************/
 /*  Layouts descriptor  */
 /************************/
-static const key_layout_t
+static const gui_widget_tree_t
 layouts[] = {
-    {.id = GUI_ID_KEYBOARD_LAYOUT_ABC, .rows = keyboard_rows_l1, .rows_count = GUI_COUNT_OF(keyboard_rows_l1)},
-    {.id = GUI_ID_KEYBOARD_LAYOUT_123, .rows = keyboard_rows_l2, .rows_count = GUI_COUNT_OF(keyboard_rows_l2)},
-    {.id = GUI_ID_KEYBOARD_LAYOUT_CALC, .rows = keyboard_rows_l3, .rows_count = GUI_COUNT_OF(keyboard_rows_l3)},
+    KEY_LAYOUT(GUI_ID_KEYBOARD_LAYOUT_ABC, keys_l1, 0),
+    KEY_LAYOUT(GUI_ID_KEYBOARD_LAYOUT_123, keys_l2, GUI_FLAG_WIDGET_TREE_HIDDEN | GUI_FLAG_WIDGET_TREE_DEFERRED),
+    KEY_LAYOUT(GUI_ID_KEYBOARD_LAYOUT_CALC, keys_l3, GUI_FLAG_WIDGET_TREE_HIDDEN | GUI_FLAG_WIDGET_TREE_DEFERRED),
 };
 
 static key_info_t
@@ -311,6 +264,10 @@ keyboard = {
 static uint8_t
 keyboard_btn_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const param, gui_evt_result_t* const result) {
     switch (evt) {
+        case GUI_EVT_INIT: {                        /* Keys are drawn without 3D style */
+            gui_button_set3dstyle(h, 0);
+            return gui_widget_processdefaultcallback(h, evt, param, result);
+        }
         case GUI_EVT_DRAW: {                        /* Draw button */
             gui_char str[10] = {0};
             const key_btn_t* kbtn;
@@ -482,12 +439,6 @@ keyboard_base_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* co
             return 1;
         }
         case GUI_EVT_INIT: {                         /* When base element is initialized */
-            gui_handle_p handle, handleLayout;
-            size_t i, k, z;
-            const key_layout_t* layout;
-            const key_row_t* row;
-            const key_btn_t* btn;
-            
             /***************************/
             /*   Configure keyboard    */
             /***************************/
@@ -503,41 +454,7 @@ keyboard_base_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* co
             /***************************/
             /* Create keyboard layouts */
             /***************************/
-            for (i = 0; i < GUI_COUNT_OF(layouts); i++) {
-                layout = &layouts[i];               /* Get layout data */
-                
-                /***************************/
-                /* Create keyboard layout  */
-                /***************************/
-                handleLayout = gui_container_create(layout->id, 0, 0, 100, 100, h, keyboard_callback, GUI_FLAG_WIDGET_CREATE_IGNORE_INVALIDATE);
-                gui_widget_setsizepercent(handleLayout, 100, 50);
-                gui_widget_setpositionpercent(handleLayout, 0, 50);
-                gui_widget_setuserdata(handleLayout, (void *)layout);
-                if (i) {                            /* Show only first layout */
-                    gui_widget_hide(handleLayout);
-                } else {                            /* Save main layout handle */
-                    keyboard.main_layout_handle = handleLayout;
-                }
-                gui_widget_setignoreinvalidate(handleLayout, 0, 1);
-                
-                /***************************/
-                /* Draw buttons on layout  */
-                /***************************/
-                for (k = 0; k < layout->rows_count; k++) {
-                    row = &layout->rows[k];
-                    for (z = 0; z < row->btns_count; z++) {
-                        btn = &row->btns[z];
-                        
-                        handle = gui_button_create(0, 0, 0, 1, 1, handleLayout, keyboard_btn_callback, GUI_FLAG_WIDGET_CREATE_IGNORE_INVALIDATE);   /* Create button object */
-                        gui_button_set3dstyle(handle, 0);
-                        gui_widget_setuserdata(handle, (void *)btn);
-                        gui_widget_setsizepercent(handle, btn->w, 23);
-                        gui_widget_setpositionpercent(handle, btn->x, GUI_DIM(1 + (100.0f / layout->rows_count) * k));
-                        gui_widget_setzindex(handle, z);
-                        gui_widget_setignoreinvalidate(handle, 0, 1);
-                    }
-                }
-            }
+            keyboard.main_layout_handle = gui_widget_create_tree(layouts, GUI_COUNT_OF(layouts), h);
             return 1;
         }
         default:                                    /* Handle default option */
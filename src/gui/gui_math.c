@@ -119,3 +119,24 @@ gui_math_centerofxy(float x1, float y1, float x2, float y2, float* const resultx
     
     return 1;
 }
+
+/**
+ * \brief           Calculate angle of line from first to second XY point
+ *
+ *                  \f$\ y=atan2{(y_2-y_1, x_2-x_1)}\f$
+ *
+ * \param[in]       x1: X position of point 1
+ * \param[in]       y1: Y position of point 1
+ * \param[in]       x2: X position of point 2
+ * \param[in]       y2: Y position of point 2
+ * \param[out]      result: Pointer to float variable to store result in units of degrees, between `-180` and `180`
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_math_anglebetweenxy(float x1, float y1, float x2, float y2, float* const result) {
+    if (x1 == x2 && y1 == y2) {                     /* Angle is not defined for the same points */
+        return 0;
+    }
+    *result = GUI_FLOAT(atan2(y2 - y1, x2 - x1) * 180.0 / 3.14159265358979);
+    return 1;
+}
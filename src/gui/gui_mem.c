@@ -35,11 +35,6 @@
 #include "gui/gui.h"
 #include "gui/gui_mem.h"
 
-typedef struct MemBlock {
-    struct MemBlock* NextFreeBlock;                 /*!< Pointer to next free block */
-    size_t Size;                                    /*!< Size of block */
-} MemBlock_t;
-
 /**
  * \brief           Memory alignment bits and absolute number
  */
@@ -47,15 +42,617 @@ typedef struct MemBlock {
 #define MEM_ALIGN_NUM               ((size_t)GUI_CFG_MEM_ALIGNMENT)
 #define MEM_ALIGN(x)                GUI_MEM_ALIGN(x)
 
+static size_t MemAvailableBytes = 0;
+static size_t MemMinAvailableBytes = 0;
+
+static size_t MemTotalSize = 0;                     /* Size of memory in units of bytes */
+
+/**
+ * \brief           Memory region in use
+ */
+typedef struct {
+    uint8_t* start;                                 /*!< Start address of memory for blocks */
+    uint8_t* end;                                   /*!< Address after last byte of region */
+    uint8_t mem_class;                              /*!< Allocation class of region, member of \ref gui_mem_class_t */
+} mem_region_info_t;
+
+static mem_region_info_t MemRegions[GUI_CFG_MEM_REGIONS];
+static size_t MemRegionsCount;
+static size_t MemClassRegions[GUI_MEM_CLASS_END];   /* Number of regions of every class */
+
+/* Order of region classes tried for every allocation class */
+static const uint8_t MemClassOrder[GUI_MEM_CLASS_END][GUI_MEM_CLASS_END] = {
+    { GUI_MEM_CLASS_DEFAULT, GUI_MEM_CLASS_BULK, GUI_MEM_CLASS_FAST },  /* Fast memory is kept for fast class */
+    { GUI_MEM_CLASS_FAST, GUI_MEM_CLASS_DEFAULT, GUI_MEM_CLASS_BULK },
+    { GUI_MEM_CLASS_BULK, GUI_MEM_CLASS_DEFAULT, GUI_MEM_CLASS_FAST },
+};
+
+/* Allocation class of every tag */
+static uint8_t MemTagClass[GUI_MEM_TAG_END] = {
+    GUI_MEM_CLASS_DEFAULT,                          /* GUI_MEM_TAG_OTHER */
+    GUI_MEM_CLASS_FAST,                             /* GUI_MEM_TAG_WIDGET */
+    GUI_MEM_CLASS_BULK,                             /* GUI_MEM_TAG_GLYPH */
+    GUI_MEM_CLASS_DEFAULT,                          /* GUI_MEM_TAG_TEXT */
+    GUI_MEM_CLASS_FAST,                             /* GUI_MEM_TAG_TIMER */
+    GUI_MEM_CLASS_BULK,                             /* GUI_MEM_TAG_LAYER */
+    GUI_MEM_CLASS_DEFAULT,                          /* GUI_MEM_TAG_ITEM */
+};
+
+/**
+ * \brief           Add region to list of used regions
+ * \param[in]       start: Start address of aligned region memory
+ * \param[in]       size: Size of aligned region memory
+ * \param[in]       mem_class: Allocation class of region
+ */
+static void
+mem_addregion(uint8_t* start, size_t size, uint8_t mem_class) {
+    MemRegions[MemRegionsCount].start = start;
+    MemRegions[MemRegionsCount].end = start + size;
+    MemRegions[MemRegionsCount].mem_class = mem_class;
+    MemRegionsCount++;
+    MemClassRegions[mem_class]++;
+}
+
+/**
+ * \brief           Get allocation class of region where memory is placed
+ * \param[in]       ptr: Memory address
+ * \return          Allocation class of region
+ */
+static uint8_t
+mem_getclass(const void* ptr) {
+    size_t i;
+
+    for (i = 0; i < MemRegionsCount; i++) {
+        if ((const uint8_t *)ptr >= MemRegions[i].start && (const uint8_t *)ptr < MemRegions[i].end) {
+            return MemRegions[i].mem_class;
+        }
+    }
+    return GUI_MEM_CLASS_DEFAULT;
+}
+
+#if GUI_CFG_MEM_POOL_CLASSES || __DOXYGEN__
+
+/**
+ * \brief           Chunk of objects in memory pool
+ */
+typedef struct mem_pool_chunk {
+    struct mem_pool_chunk* next;                    /*!< Next chunk in pool */
+    struct mem_pool_chunk* prev;                    /*!< Previous chunk in pool */
+    void* free;                                     /*!< First free object in chunk */
+    size_t used;                                    /*!< Number of allocated objects in chunk */
+} mem_pool_chunk_t;
+
+/**
+ * \brief           Memory pool for objects of the same size
+ */
+typedef struct {
+    size_t size;                                    /*!< Object size, `0` when class is not used yet */
+    mem_pool_chunk_t* first;                        /*!< First chunk. Chunks with free objects are before full ones */
+    mem_pool_chunk_t* last;                         /*!< Last chunk */
+    size_t chunks;                                  /*!< Number of chunks in pool */
+    size_t chunks_empty;                            /*!< Number of chunks without allocated objects */
+    size_t used;                                    /*!< Number of allocated objects */
+    size_t max_used;                                /*!< Maximal number of allocated objects */
+} mem_pool_t;
+
+/* Object is preceded by pointer to its chunk */
+#define MEM_POOL_CHUNK_METASIZE     MEM_ALIGN(sizeof(mem_pool_chunk_t))
+#define MEM_POOL_OBJ_METASIZE       MEM_ALIGN(sizeof(mem_pool_chunk_t *))
+#define MEM_POOL_OBJ_SIZE(size)     (MEM_POOL_OBJ_METASIZE + MEM_ALIGN(GUI_MAX((size), sizeof(void *))))
+#define MEM_POOL_OBJ_CHUNK(ptr)     (*(mem_pool_chunk_t **)(((uint8_t *)(ptr)) - MEM_POOL_OBJ_METASIZE))
+#define MEM_POOL_OBJ_NEXT(ptr)      (*(void **)(ptr))
+
+static mem_pool_t MemPools[GUI_CFG_MEM_POOL_CLASSES];
+
+#endif /* GUI_CFG_MEM_POOL_CLASSES || __DOXYGEN__ */
+
+/**
+ * \brief           Add free block to fragmentation statistics
+ *
+ *                  Histogram entry `0` counts blocks smaller than `32` bytes,
+ *                  entry `i` counts blocks from `16 << i` to `(32 << i) - 1` bytes
+ *                  and last entry counts all larger blocks too
+ *
+ * \param[in]       size: Number of bytes available for user in free block
+ * \param[in,out]   largest: Size of largest free block found so far
+ * \param[in,out]   hist: Histogram array or `NULL` if not used
+ * \param[in]       len: Number of histogram entries
+ */
+static void
+mem_addfreeblock(size_t size, size_t* largest, size_t* hist, size_t len) {
+    size_t i;
+
+    if (size > *largest) {
+        *largest = size;
+    }
+    if (hist != NULL && len) {
+        for (i = 0; i < (len - 1) && size >= 32; i++, size >>= 1) {}
+        hist[i]++;
+    }
+}
+
+#if GUI_CFG_MEM_TLSF || __DOXYGEN__
+
+#if GUI_CFG_MEM_ALIGNMENT < 4
+#error "GUI_CFG_MEM_ALIGNMENT must be at least 4 when GUI_CFG_MEM_TLSF is enabled"
+#endif /* GUI_CFG_MEM_ALIGNMENT < 4 */
+#if GUI_CFG_MEM_TLSF_SL_BITS < 1 || GUI_CFG_MEM_TLSF_SL_BITS > 5
+#error "GUI_CFG_MEM_TLSF_SL_BITS must be between 1 and 5"
+#endif /* GUI_CFG_MEM_TLSF_SL_BITS < 1 || GUI_CFG_MEM_TLSF_SL_BITS > 5 */
+
+/**
+ * \brief           Memory block of TLSF allocator
+ *
+ *                  Pointer to physically previous block and size are always valid.
+ *                  Free list pointers are valid only when block is free and use memory of user data
+ */
+typedef struct mem_tlsf_block {
+    struct mem_tlsf_block* prev_phys;               /*!< Physically previous block in region or `NULL` for first block */
+    size_t size;                                    /*!< Block size including header. Bit `0` is set when block is free */
+    struct mem_tlsf_block* next_free;               /*!< Next free block in the same list */
+    struct mem_tlsf_block* prev_free;               /*!< Previous free block in the same list */
+} mem_tlsf_block_t;
+
+#define MEM_TLSF_BLOCK_FREE         ((size_t)0x01)
+#define MEM_TLSF_BLOCK_METASIZE     MEM_ALIGN(offsetof(mem_tlsf_block_t, next_free))
+#define MEM_TLSF_BLOCK_MINSIZE      MEM_ALIGN(sizeof(mem_tlsf_block_t))
+#define MEM_TLSF_BLOCK_SIZE(b)      ((b)->size & ~MEM_TLSF_BLOCK_FREE)
+#define MEM_TLSF_BLOCK_NEXT(b)      ((mem_tlsf_block_t *)(((uint8_t *)(b)) + MEM_TLSF_BLOCK_SIZE(b)))
+#define MEM_TLSF_BLOCK_FROMPTR(ptr) ((mem_tlsf_block_t *)(((uint8_t *)(ptr)) - MEM_TLSF_BLOCK_METASIZE))
+
+/*
+ * First level index is power of 2 of block size, second level splits it linearly.
+ * Blocks smaller than MEM_TLSF_SMALL_SIZE are all in first level list 0,
+ * with second level lists every 4 bytes
+ */
+#define MEM_TLSF_SL_COUNT           ((uint32_t)1 << GUI_CFG_MEM_TLSF_SL_BITS)
+#define MEM_TLSF_FL_SHIFT           (GUI_CFG_MEM_TLSF_SL_BITS + 2)
+#define MEM_TLSF_SMALL_SIZE         ((size_t)1 << MEM_TLSF_FL_SHIFT)
+#define MEM_TLSF_FL_COUNT           (32 - MEM_TLSF_FL_SHIFT + 1)
+#define MEM_TLSF_MAX_SIZE           ((size_t)0x7FFFFFFFUL & ~MEM_ALIGN_BITS)
+
+/**
+ * \brief           TLSF control structure with lists of free blocks
+ */
+typedef struct {
+    uint32_t fl_bitmap;                             /*!< Bit is set for every first level with at least one free block */
+    uint32_t sl_bitmap[MEM_TLSF_FL_COUNT];          /*!< Bit is set for every second level list with at least one free block */
+    mem_tlsf_block_t* blocks[MEM_TLSF_FL_COUNT][MEM_TLSF_SL_COUNT];    /*!< Lists of free blocks */
+} mem_tlsf_t;
+
+#define MEM_TLSF_CONTROL_SIZE       MEM_ALIGN(sizeof(mem_tlsf_t))
+
+/* Control structure of every allocation class, placed at the beginning of first region of class */
+static mem_tlsf_t* MemTlsf[GUI_MEM_CLASS_END];
+static uint8_t MemTlsfAssigned;                     /* Set to `1` when regions are assigned */
+
+/**
+ * \brief           Get index of most significant bit set
+ * \param[in]       x: Value, must not be `0`
+ * \return          Bit index, from `0` to `31`
+ */
+static uint8_t
+mem_tlsf_fls(uint32_t x) {
+#if defined(__GNUC__)
+    return (uint8_t)(31 - __builtin_clz(x));
+#else /* defined(__GNUC__) */
+    uint8_t bit = 0;
+
+    if (x & 0xFFFF0000UL) { x >>= 16; bit += 16; }
+    if (x & 0x0000FF00UL) { x >>= 8;  bit += 8; }
+    if (x & 0x000000F0UL) { x >>= 4;  bit += 4; }
+    if (x & 0x0000000CUL) { x >>= 2;  bit += 2; }
+    if (x & 0x00000002UL) { bit += 1; }
+    return bit;
+#endif /* !defined(__GNUC__) */
+}
+
+/* Get index of least significant bit set */
+#define mem_tlsf_ffs(x)             mem_tlsf_fls((x) & (~(x) + 1))
+
+/**
+ * \brief           Get first and second level list index for block size
+ * \param[in]       size: Block size
+ * \param[out]      fl: First level index
+ * \param[out]      sl: Second level index
+ */
+static void
+mem_tlsf_mapping(size_t size, uint8_t* fl, uint8_t* sl) {
+    uint8_t f;
+
+    if (size < MEM_TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = (uint8_t)(size >> 2);
+    } else {
+        f = mem_tlsf_fls((uint32_t)size);
+        *sl = (uint8_t)((size >> (f - GUI_CFG_MEM_TLSF_SL_BITS)) ^ MEM_TLSF_SL_COUNT);
+        *fl = (uint8_t)(f - MEM_TLSF_FL_SHIFT + 1);
+    }
+}
+
+/**
+ * \brief           Add block to list of free blocks and mark it as free
+ * \param[in]       t: Control structure of block region class
+ * \param[in]       block: Block to insert
+ */
+static void
+mem_tlsf_insert(mem_tlsf_t* t, mem_tlsf_block_t* block) {
+    uint8_t fl, sl;
+
+    mem_tlsf_mapping(MEM_TLSF_BLOCK_SIZE(block), &fl, &sl);
+    block->prev_free = NULL;
+    block->next_free = t->blocks[fl][sl];
+    if (block->next_free != NULL) {
+        block->next_free->prev_free = block;
+    }
+    t->blocks[fl][sl] = block;
+    t->fl_bitmap |= (uint32_t)1 << fl;
+    t->sl_bitmap[fl] |= (uint32_t)1 << sl;
+    block->size |= MEM_TLSF_BLOCK_FREE;
+}
+
+/**
+ * \brief           Remove block from list of free blocks and mark it as used
+ * \param[in]       t: Control structure of block region class
+ * \param[in]       block: Free block to remove
+ */
+static void
+mem_tlsf_remove(mem_tlsf_t* t, mem_tlsf_block_t* block) {
+    uint8_t fl, sl;
+
+    mem_tlsf_mapping(MEM_TLSF_BLOCK_SIZE(block), &fl, &sl);
+    if (block->next_free != NULL) {
+        block->next_free->prev_free = block->prev_free;
+    }
+    if (block->prev_free != NULL) {
+        block->prev_free->next_free = block->next_free;
+    } else {
+        t->blocks[fl][sl] = block->next_free;
+        if (t->blocks[fl][sl] == NULL) {            /* List is empty now */
+            t->sl_bitmap[fl] &= ~((uint32_t)1 << sl);
+            if (!t->sl_bitmap[fl]) {
+                t->fl_bitmap &= ~((uint32_t)1 << fl);
+            }
+        }
+    }
+    block->size &= ~MEM_TLSF_BLOCK_FREE;
+}
+
+/**
+ * \brief           Find free block of at least required size
+ * \param[in]       t: Control structure of region class
+ * \param[in]       size: Required block size
+ * \return          Free block on success, `NULL` otherwise
+ */
+static mem_tlsf_block_t*
+mem_tlsf_find(mem_tlsf_t* t, size_t size) {
+    uint32_t map;
+    uint8_t fl, sl;
+
+    /* Round size up to next list, so that any block in found list is large enough */
+    if (size >= MEM_TLSF_SMALL_SIZE) {
+        size += ((size_t)1 << (mem_tlsf_fls((uint32_t)size) - GUI_CFG_MEM_TLSF_SL_BITS)) - 1;
+    }
+    mem_tlsf_mapping(size, &fl, &sl);
+    if (fl >= MEM_TLSF_FL_COUNT) {
+        return NULL;
+    }
+
+    map = t->sl_bitmap[fl] & (~(uint32_t)0 << sl);  /* Lists of the same first level */
+    if (!map) {
+        map = t->fl_bitmap & (~(uint32_t)0 << (fl + 1));    /* Any larger first level */
+        if (!map) {
+            return NULL;
+        }
+        fl = mem_tlsf_ffs(map);
+        map = t->sl_bitmap[fl];
+    }
+    sl = mem_tlsf_ffs(map);
+    return t->blocks[fl][sl];
+}
+
+uint8_t
+mem_assignmem(const mem_region_t* regions, size_t len) {
+    uint8_t* MemStartAddr;
+    size_t MemSize;
+    mem_tlsf_block_t *first, *end;
+    size_t i;
+    uint8_t mem_class;
+
+    if (MemTlsfAssigned || len > GUI_CFG_MEM_REGIONS) { /* Regions already defined or too many regions */
+        return 0;
+    }
+
+    /* Check if region address are linear and rising */
+    MemStartAddr = (uint8_t *)0;
+    for (i = 0; i < len; i++) {
+        if (MemStartAddr >= (uint8_t *)regions[i].start_address) {  /* Check if previous greater than current */
+            return 0;                               /* Return as invalid and failed */
+        }
+        MemStartAddr = (uint8_t *)regions[i].start_address; /* Save as previous address */
+    }
+
+    for (; len--; regions++) {
+        /* Check minimum region size */
+        MemSize = regions->size;
+        if (MemSize < (MEM_ALIGN_NUM + MEM_TLSF_BLOCK_METASIZE + MEM_TLSF_BLOCK_MINSIZE)) {
+            continue;
+        }
+
+        /* Align start address and size of region */
+        MemStartAddr = (uint8_t *)regions->start_address;
+        if ((size_t)MemStartAddr & MEM_ALIGN_BITS) {
+            MemStartAddr += MEM_ALIGN_NUM - ((size_t)MemStartAddr & MEM_ALIGN_BITS);
+            MemSize -= MemStartAddr - (uint8_t *)regions->start_address;
+        }
+        if (MemSize > MEM_TLSF_MAX_SIZE) {          /* Block size must fit to 32-bits */
+            MemSize = MEM_TLSF_MAX_SIZE;
+        }
+        MemSize &= ~MEM_ALIGN_BITS;
+
+        /* First region of class holds control structure */
+        mem_class = regions->mem_class < GUI_MEM_CLASS_END ? (uint8_t)regions->mem_class : GUI_MEM_CLASS_DEFAULT;
+        if (MemTlsf[mem_class] == NULL) {
+            if (MemSize < (MEM_TLSF_CONTROL_SIZE + MEM_TLSF_BLOCK_METASIZE + MEM_TLSF_BLOCK_MINSIZE)) {
+                continue;
+            }
+            MemTlsf[mem_class] = (mem_tlsf_t *)MemStartAddr;
+            memset(MemTlsf[mem_class], 0x00, sizeof(*MemTlsf[mem_class]));
+            MemStartAddr += MEM_TLSF_CONTROL_SIZE;
+            MemSize -= MEM_TLSF_CONTROL_SIZE;
+        }
+        mem_addregion(MemStartAddr, MemSize, mem_class);
+
+        /*
+         * Region is one free block, followed by end block header.
+         * End block is always used and stops merging with memory after region
+         */
+        first = (mem_tlsf_block_t *)MemStartAddr;
+        first->prev_phys = NULL;
+        first->size = MemSize - MEM_TLSF_BLOCK_METASIZE;
+        end = MEM_TLSF_BLOCK_NEXT(first);
+        end->prev_phys = first;
+        end->size = 0;
+        mem_tlsf_insert(MemTlsf[mem_class], first);
+
+        MemAvailableBytes += MEM_TLSF_BLOCK_SIZE(first);
+        MemTotalSize += MEM_TLSF_BLOCK_SIZE(first);
+    }
+
+    MemMinAvailableBytes = MemAvailableBytes;       /* Save minimum ever available bytes in region */
+    MemTlsfAssigned = 1;
+
+    return 1;                                       /* Regions set as expected */
+}
+
+static void*
+mem_alloc(size_t size, uint8_t mem_class) {
+    mem_tlsf_block_t *block = NULL, *next;
+    mem_tlsf_t* t = NULL;
+    size_t block_size, i;
+
+    if (!MemTlsfAssigned || !size || size > MEM_TLSF_MAX_SIZE) {
+        return NULL;
+    }
+
+    size = MEM_ALIGN(size) + MEM_TLSF_BLOCK_METASIZE;
+    if (size < MEM_TLSF_BLOCK_MINSIZE) {            /* Block must hold free list pointers when freed */
+        size = MEM_TLSF_BLOCK_MINSIZE;
+    }
+    if (size > MemAvailableBytes) {                 /* Check if we have enough memory available */
+        return NULL;
+    }
+
+    /* Try regions of allocation class first, then other regions in fallback order */
+    for (i = 0; i < GUI_MEM_CLASS_END && block == NULL; i++) {
+        t = MemTlsf[MemClassOrder[mem_class][i]];
+        if (t != NULL) {
+            block = mem_tlsf_find(t, size);
+        }
+    }
+    if (block == NULL) {                            /* No free block of required size */
+        return NULL;
+    }
+    mem_tlsf_remove(t, block);
+
+    /* Split block when remaining memory is large enough for new block */
+    block_size = MEM_TLSF_BLOCK_SIZE(block);
+    if ((block_size - size) >= MEM_TLSF_BLOCK_MINSIZE) {
+        next = (mem_tlsf_block_t *)(((uint8_t *)block) + size);
+        next->prev_phys = block;
+        next->size = block_size - size;
+        MEM_TLSF_BLOCK_NEXT(next)->prev_phys = next;
+        block->size = size;
+        mem_tlsf_insert(t, next);
+    }
+
+    MemAvailableBytes -= MEM_TLSF_BLOCK_SIZE(block);/* Decrease available memory */
+    if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+        MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+    }
+    return ((uint8_t *)block) + MEM_TLSF_BLOCK_METASIZE;
+}
+
+static void
+mem_free(void* ptr) {
+    mem_tlsf_block_t *block, *next;
+    mem_tlsf_t* t;
+
+    if (ptr == NULL) {                              /* To be in compliance with C free function */
+        return;
+    }
+
+    block = MEM_TLSF_BLOCK_FROMPTR(ptr);
+    if ((block->size & MEM_TLSF_BLOCK_FREE) || !MEM_TLSF_BLOCK_SIZE(block)) {   /* Block is not allocated */
+        return;
+    }
+    MemAvailableBytes += MEM_TLSF_BLOCK_SIZE(block);/* Increase available bytes back */
+    t = MemTlsf[mem_getclass(block)];
+
+    /* Merge with physically previous and next blocks when free */
+    if (block->prev_phys != NULL && (block->prev_phys->size & MEM_TLSF_BLOCK_FREE)) {
+        mem_tlsf_remove(t, block->prev_phys);
+        block->prev_phys->size += block->size;
+        block = block->prev_phys;
+    }
+    next = MEM_TLSF_BLOCK_NEXT(block);
+    if (next->size & MEM_TLSF_BLOCK_FREE) {
+        mem_tlsf_remove(t, next);
+        block->size += next->size;
+        next = MEM_TLSF_BLOCK_NEXT(block);
+    }
+    next->prev_phys = block;
+    mem_tlsf_insert(t, block);
+}
+
+/* Get size of user memory from input pointer */
+static size_t
+mem_getusersize(void* ptr) {
+    mem_tlsf_block_t* block;
+
+    if (ptr == NULL) {
+        return 0;
+    }
+    block = MEM_TLSF_BLOCK_FROMPTR(ptr);
+    if (!(block->size & MEM_TLSF_BLOCK_FREE)) {     /* Memory is actually allocated */
+        return MEM_TLSF_BLOCK_SIZE(block) - MEM_TLSF_BLOCK_METASIZE;
+    }
+    return 0;
+}
+
+/* Resize allocated block in place, return `1` on success */
+static uint8_t
+mem_resize(void* ptr, size_t size) {
+    mem_tlsf_block_t *block, *next, *tail;
+    mem_tlsf_t* t;
+    size_t block_size;
+
+    block = MEM_TLSF_BLOCK_FROMPTR(ptr);
+    if (!size || size > MEM_TLSF_MAX_SIZE || (block->size & MEM_TLSF_BLOCK_FREE)) {
+        return 0;
+    }
+    t = MemTlsf[mem_getclass(block)];
+    size = MEM_ALIGN(size) + MEM_TLSF_BLOCK_METASIZE;
+    if (size < MEM_TLSF_BLOCK_MINSIZE) {
+        size = MEM_TLSF_BLOCK_MINSIZE;
+    }
+
+    /* Grow to physically next block when it is free and large enough */
+    block_size = MEM_TLSF_BLOCK_SIZE(block);
+    if (size > block_size) {
+        next = MEM_TLSF_BLOCK_NEXT(block);
+        if (!(next->size & MEM_TLSF_BLOCK_FREE) || (block_size + MEM_TLSF_BLOCK_SIZE(next)) < size) {
+            return 0;
+        }
+        mem_tlsf_remove(t, next);
+        MemAvailableBytes -= next->size;
+        block->size += next->size;
+        block_size = block->size;
+        MEM_TLSF_BLOCK_NEXT(block)->prev_phys = block;
+    }
+
+    /* Return unused tail of block to free lists */
+    if ((block_size - size) >= MEM_TLSF_BLOCK_MINSIZE) {
+        tail = (mem_tlsf_block_t *)(((uint8_t *)block) + size);
+        tail->prev_phys = block;
+        tail->size = block_size - size;
+        block->size = size;
+        MemAvailableBytes += tail->size;
+
+        next = MEM_TLSF_BLOCK_NEXT(tail);
+        if (next->size & MEM_TLSF_BLOCK_FREE) {     /* Merge tail with next free block */
+            mem_tlsf_remove(t, next);
+            tail->size += next->size;
+            next = MEM_TLSF_BLOCK_NEXT(tail);
+        }
+        next->prev_phys = tail;
+        mem_tlsf_insert(t, tail);
+    }
+
+    if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+        MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+    }
+    return 1;
+}
+
+#if GUI_CFG_MEM_COMPACT
+
+/* Move allocated block to physically previous free block, return new pointer or `NULL` if not moved */
+static void*
+mem_slide(void* ptr) {
+    mem_tlsf_block_t *block, *prev, *next, *tail;
+    mem_tlsf_t* t;
+    size_t block_size, hole_size;
+
+    block = MEM_TLSF_BLOCK_FROMPTR(ptr);
+    prev = block->prev_phys;
+    if ((block->size & MEM_TLSF_BLOCK_FREE) || prev == NULL || !(prev->size & MEM_TLSF_BLOCK_FREE)) {
+        return NULL;
+    }
+    t = MemTlsf[mem_getclass(block)];
+    mem_tlsf_remove(t, prev);
+    hole_size = MEM_TLSF_BLOCK_SIZE(prev);
+    block_size = MEM_TLSF_BLOCK_SIZE(block);
+
+    /* Previous free block becomes allocated block, free space moves after it */
+    memmove(((uint8_t *)prev) + MEM_TLSF_BLOCK_METASIZE, ptr, block_size - MEM_TLSF_BLOCK_METASIZE);
+    prev->size = block_size;
+    tail = MEM_TLSF_BLOCK_NEXT(prev);
+    tail->prev_phys = prev;
+    tail->size = hole_size;
+
+    next = MEM_TLSF_BLOCK_NEXT(tail);
+    if (next->size & MEM_TLSF_BLOCK_FREE) {         /* Merge free space with next free block */
+        mem_tlsf_remove(t, next);
+        tail->size += next->size;
+        next = MEM_TLSF_BLOCK_NEXT(tail);
+    }
+    next->prev_phys = tail;
+    mem_tlsf_insert(t, tail);
+    return ((uint8_t *)prev) + MEM_TLSF_BLOCK_METASIZE;
+}
+
+#endif /* GUI_CFG_MEM_COMPACT */
+
+/* Scan all free blocks for largest block and histogram, return number of free blocks */
+static size_t
+mem_getfreeblocks(size_t* largest, size_t* hist, size_t len) {
+    mem_tlsf_block_t* block;
+    mem_tlsf_t* t;
+    size_t c, fl, sl, count = 0;
+
+    for (c = 0; c < GUI_MEM_CLASS_END; c++) {
+        if ((t = MemTlsf[c]) == NULL) {
+            continue;
+        }
+        for (fl = 0; fl < MEM_TLSF_FL_COUNT; fl++) {
+            if (!(t->fl_bitmap & ((uint32_t)1 << fl))) {
+                continue;
+            }
+            for (sl = 0; sl < MEM_TLSF_SL_COUNT; sl++) {
+                for (block = t->blocks[fl][sl]; block != NULL; block = block->next_free) {
+                    mem_addfreeblock(MEM_TLSF_BLOCK_SIZE(block) - MEM_TLSF_BLOCK_METASIZE, largest, hist, len);
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+#else /* GUI_CFG_MEM_TLSF || __DOXYGEN__ */
+
+typedef struct MemBlock {
+    struct MemBlock* NextFreeBlock;                 /*!< Pointer to next free block */
+    size_t Size;                                    /*!< Size of block */
+} MemBlock_t;
+
 #define MEMBLOCK_METASIZE           MEM_ALIGN(sizeof(MemBlock_t))
 
 static MemBlock_t StartBlock;
 static MemBlock_t* EndBlock = 0;
-static size_t MemAvailableBytes = 0;
-static size_t MemMinAvailableBytes = 0;
 static size_t MemAllocBit = 0;
 
-static size_t MemTotalSize = 0;                     /* Size of memory in units of bytes */
 /* Insert block to list of free blocks */
 static void
 mem_insertfreeblock(MemBlock_t* newBlock) {
@@ -109,7 +706,7 @@ mem_assignmem(const mem_region_t* regions, size_t len) {
     MemBlock_t* PreviousEndBlock = 0;
     size_t i;
     
-    if (EndBlock != NULL) {                         /* Regions already defined */
+    if (EndBlock != NULL || len > GUI_CFG_MEM_REGIONS) {    /* Regions already defined or too many regions */
         return 0;
     }
     
@@ -143,6 +740,8 @@ mem_assignmem(const mem_region_t* regions, size_t len) {
         if (MemSize & MEM_ALIGN_BITS) {
             MemSize &= ~MEM_ALIGN_BITS;             /* Clear lower bits of memory size only */
         }
+        mem_addregion(MemStartAddr, MemSize,
+            regions->mem_class < GUI_MEM_CLASS_END ? (uint8_t)regions->mem_class : GUI_MEM_CLASS_DEFAULT);
 
         /*
          * StartBlock is fixed variable for start list of free blocks
@@ -186,6 +785,7 @@ mem_assignmem(const mem_region_t* regions, size_t len) {
         
         /* Set number of free bytes available to allocate in region */
         MemAvailableBytes += FirstBlock->Size;
+        MemTotalSize += FirstBlock->Size;
         
         regions++;                                  /* Go to next region */
     }
@@ -201,9 +801,11 @@ mem_assignmem(const mem_region_t* regions, size_t len) {
 }
 
 static void*
-mem_alloc(size_t size) {
+mem_alloc(size_t size, uint8_t mem_class) {
     MemBlock_t *Prev, *Curr, *Next;
     void* retval = 0;
+    size_t i;
+    uint8_t heap;
 
     if (EndBlock == NULL) {                         /* If end block is not yet defined */
         return 0;                                   /* Invalid, not initialized */
@@ -223,12 +825,23 @@ mem_alloc(size_t size) {
      * Try to find sufficient block for data
      * Go through free blocks until enough memory is found
      * or end block is reached (no next free block)
+     *
+     * Regions of allocation class are checked first,
+     * other regions are used in fallback order when there is no free block
      */
-    Prev = &StartBlock;                             /* Set first first block as previous */
-    Curr = Prev->NextFreeBlock;                     /* Set next block as current */
-    while ((Curr->Size < size) && (Curr->NextFreeBlock)) {
-        Prev = Curr;
-        Curr = Curr->NextFreeBlock;
+    Prev = &StartBlock;
+    Curr = EndBlock;
+    for (i = 0; i < GUI_MEM_CLASS_END && Curr == EndBlock; i++) {
+        heap = MemClassOrder[mem_class][i];
+        if (!MemClassRegions[heap]) {               /* No regions of this class */
+            continue;
+        }
+        Prev = &StartBlock;                         /* Set first first block as previous */
+        Curr = Prev->NextFreeBlock;                 /* Set next block as current */
+        while ((Curr->Size < size || mem_getclass(Curr) != heap) && (Curr->NextFreeBlock)) {
+            Prev = Curr;
+            Curr = Curr->NextFreeBlock;
+        }
     }
     
     /*
@@ -258,10 +871,10 @@ mem_alloc(size_t size) {
              */
             mem_insertfreeblock(Next);              /* Insert free memory block to list of free memory blocks (linked list chain) */
         }
+        MemAvailableBytes -= Curr->Size;            /* Decrease available memory, block may be larger than requested when not split */
         Curr->Size |= MemAllocBit;                  /* Set allocated bit = memory is allocated */
         Curr->NextFreeBlock = 0;                    /* Clear next free block pointer as there is no one */
 
-        MemAvailableBytes -= size;                  /* Decrease available memory */
         if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
             MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
         }
@@ -312,30 +925,119 @@ mem_getusersize(void* ptr) {
     return 0;
 }
 
-/* Allocate memory and set it to 0 */
-static void*
-mem_calloc(size_t num, size_t size) {
-    void* ptr;
-    size_t tot_len = num * size;
-    
-    if ((ptr = mem_alloc(tot_len)) != NULL) {       /* Try to allocate memory */
-        memset(ptr, 0x00, tot_len);                 /* Reset entire memory */
+/* Resize allocated block in place, return `1` on success */
+static uint8_t
+mem_resize(void* ptr, size_t size) {
+    MemBlock_t *block, *prev, *next;
+    size_t block_size;
+
+    block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);
+    if (!size || size >= MemAllocBit || !(block->Size & MemAllocBit) || block->NextFreeBlock != NULL) {
+        return 0;
     }
-    return ptr;
+    size = MEM_ALIGN(size) + MEMBLOCK_METASIZE;
+
+    /* Grow to physically next block when it is free and large enough */
+    block_size = block->Size & ~MemAllocBit;
+    if (size > block_size) {
+        next = (MemBlock_t *)(((uint8_t *)block) + block_size);
+
+        /* Free blocks are sorted by address, find block before next one */
+        for (prev = &StartBlock; prev->NextFreeBlock != NULL && prev->NextFreeBlock < next; prev = prev->NextFreeBlock);
+        if (prev->NextFreeBlock != next || (block_size + next->Size) < size) {  /* End blocks have size 0 */
+            return 0;
+        }
+        prev->NextFreeBlock = next->NextFreeBlock;  /* Remove next block from free chain */
+        MemAvailableBytes -= next->Size;
+        block_size += next->Size;
+    }
+
+    /* Return unused tail of block to free chain */
+    if ((block_size - size) > (2 * MEMBLOCK_METASIZE)) {
+        next = (MemBlock_t *)(((uint8_t *)block) + size);
+        next->Size = block_size - size;
+        MemAvailableBytes += next->Size;
+        mem_insertfreeblock(next);                  /* Merge with next free block if possible */
+        block_size = size;
+    }
+    block->Size = block_size | MemAllocBit;
+
+    if (MemAvailableBytes < MemMinAvailableBytes) { /* Check if current available memory is less than ever before */
+        MemMinAvailableBytes = MemAvailableBytes;   /* Update minimal available memory */
+    }
+    return 1;
 }
 
-/* Reallocate previously allocated memory */
+#if GUI_CFG_MEM_COMPACT
+
+/* Move allocated block to physically previous free block, return new pointer or `NULL` if not moved */
 static void*
-mem_realloc(void* ptr, size_t size) {
-    void* newPtr;
-    size_t oldSize;
+mem_slide(void* ptr) {
+    MemBlock_t *block, *prev, *hole, *tail;
+    size_t block_size, hole_size;
+
+    block = (MemBlock_t *)(((uint8_t *)ptr) - MEMBLOCK_METASIZE);
+    if (!(block->Size & MemAllocBit) || block->NextFreeBlock != NULL) {
+        return NULL;
+    }
+
+    /* Free blocks are sorted by address, find last free block before allocated block */
+    for (prev = &StartBlock, hole = prev->NextFreeBlock; hole->NextFreeBlock != NULL && hole->NextFreeBlock < block;
+        prev = hole, hole = hole->NextFreeBlock);
+    if (hole >= block || ((uint8_t *)hole) + hole->Size != (uint8_t *)block) {  /* End blocks have size 0 */
+        return NULL;
+    }
+    prev->NextFreeBlock = hole->NextFreeBlock;      /* Remove free block from free chain */
+    hole_size = hole->Size;
+    block_size = block->Size & ~MemAllocBit;
+
+    /* Free block becomes allocated block, free space moves after it */
+    memmove(((uint8_t *)hole) + MEMBLOCK_METASIZE, ptr, block_size - MEMBLOCK_METASIZE);
+    hole->Size = block_size | MemAllocBit;
+    hole->NextFreeBlock = NULL;
+    tail = (MemBlock_t *)(((uint8_t *)hole) + block_size);
+    tail->Size = hole_size;
+    mem_insertfreeblock(tail);                      /* Merge with next free block if possible */
+    return ((uint8_t *)hole) + MEMBLOCK_METASIZE;
+}
+
+#endif /* GUI_CFG_MEM_COMPACT */
+
+/* Scan all free blocks for largest block and histogram, return number of free blocks */
+static size_t
+mem_getfreeblocks(size_t* largest, size_t* hist, size_t len) {
+    MemBlock_t* block;
+    size_t count = 0;
+
+    if (EndBlock == NULL) {
+        return 0;
+    }
+    for (block = StartBlock.NextFreeBlock; block != NULL; block = block->NextFreeBlock) {
+        if (block->Size) {                          /* End blocks of regions are empty */
+            mem_addfreeblock(block->Size - MEMBLOCK_METASIZE, largest, hist, len);
+            count++;
+        }
+    }
+    return count;
+}
+
+#endif /* !(GUI_CFG_MEM_TLSF || __DOXYGEN__) */
+
+/* Reallocate previously allocated memory, move and copy is used only when block cannot be resized in place */
+static void*
+mem_realloc(void* ptr, size_t size) {
+    void* newPtr;
+    size_t oldSize;
     
     if (!ptr) {                                     /* If pointer is not valid */
-        return mem_alloc(size);                     /* Only allocate memory */
+        return mem_alloc(size, GUI_MEM_CLASS_DEFAULT);  /* Only allocate memory */
+    }
+    if (mem_resize(ptr, size)) {                    /* Try to grow or shrink block without copy */
+        return ptr;
     }
     
     oldSize = mem_getusersize(ptr);                 /* Get size of old pointer */
-    newPtr = mem_alloc(size);                       /* Try to allocate new memory block */
+    newPtr = mem_alloc(size, mem_getclass(ptr));    /* Try to allocate new memory block in the same class */
     if (newPtr != NULL) {                           /* Check success */
         memcpy(newPtr, ptr, size > oldSize ? oldSize : size);   /* Copy old data to new array */
         mem_free(ptr);                              /* Free old pointer */
@@ -359,6 +1061,169 @@ mem_getminfree(void) {
     return MemMinAvailableBytes;                    /* Return minimal bytes ever available */
 }
 
+/* Allocate memory from library allocator or system, allocation class is used by library allocator only */
+static void*
+mem_backend_alloc(size_t size, uint8_t mem_class) {
+#if GUI_CFG_USE_MEM
+    return mem_alloc(size, mem_class);
+#else /* GUI_CFG_USE_MEM */
+    GUI_UNUSED(mem_class);
+    return malloc(size);
+#endif /* !GUI_CFG_USE_MEM */
+}
+
+/* Reallocate memory from library allocator or system */
+static void*
+mem_backend_realloc(void* ptr, size_t size) {
+#if GUI_CFG_USE_MEM
+    return mem_realloc(ptr, size);
+#else /* GUI_CFG_USE_MEM */
+    return realloc(ptr, size);
+#endif /* !GUI_CFG_USE_MEM */
+}
+
+/* Free memory to library allocator or system */
+static void
+mem_backend_free(void* ptr) {
+#if GUI_CFG_USE_MEM
+    mem_free(ptr);
+#else /* GUI_CFG_USE_MEM */
+    free(ptr);
+#endif /* !GUI_CFG_USE_MEM */
+}
+
+#if GUI_CFG_MEM_COMPACT
+
+/* Move memory to lower address in library allocator, system memory is never moved */
+static void*
+mem_backend_slide(void* ptr) {
+#if GUI_CFG_USE_MEM
+    return mem_slide(ptr);
+#else /* GUI_CFG_USE_MEM */
+    GUI_UNUSED(ptr);
+    return NULL;
+#endif /* !GUI_CFG_USE_MEM */
+}
+
+#endif /* GUI_CFG_MEM_COMPACT */
+
+#if GUI_CFG_MEM_STATS || __DOXYGEN__
+
+/**
+ * \brief           Allocation information, placed before user memory
+ */
+typedef struct mem_info {
+#if GUI_CFG_MEM_DEBUG || __DOXYGEN__
+    struct mem_info* next;                          /*!< Next allocated block */
+    struct mem_info* prev;                          /*!< Previous allocated block */
+    const char* file;                               /*!< File where block was allocated or `NULL` if unknown */
+    uint32_t line;                                  /*!< Line where block was allocated */
+    uint32_t time;                                  /*!< Time of allocation in units of milliseconds */
+#endif /* GUI_CFG_MEM_DEBUG || __DOXYGEN__ */
+    size_t size;                                    /*!< Number of bytes requested by user */
+    uint8_t tag;                                    /*!< Allocation tag, member of \ref gui_mem_tag_t */
+} mem_info_t;
+
+#define MEM_INFO_SIZE               MEM_ALIGN(sizeof(mem_info_t))
+#define MEM_INFO_FROMPTR(ptr)       ((mem_info_t *)(((uint8_t *)(ptr)) - MEM_INFO_SIZE))
+#define MEM_INFO_TOPTR(info)        ((void *)(((uint8_t *)(info)) + MEM_INFO_SIZE))
+
+static gui_mem_tag_stat_t MemTagStats[GUI_MEM_TAG_END];
+
+#if GUI_CFG_MEM_DEBUG
+static mem_info_t* MemInfoList;                     /* List of all allocated blocks */
+static const char* MemCallsiteFile;                 /* File of next allocation */
+static uint32_t MemCallsiteLine;                    /* Line of next allocation */
+#endif /* GUI_CFG_MEM_DEBUG */
+
+/**
+ * \brief           Add allocated block to tag counters and list of allocated blocks
+ * \param[in]       info: Block information
+ */
+static void
+mem_info_add(mem_info_t* info) {
+    gui_mem_tag_stat_t* stat = &MemTagStats[info->tag];
+
+    stat->used += info->size;
+    stat->blocks++;
+    if (stat->used > stat->max_used) {
+        stat->max_used = stat->used;
+    }
+#if GUI_CFG_MEM_DEBUG
+    info->prev = NULL;
+    info->next = MemInfoList;
+    if (MemInfoList != NULL) {
+        MemInfoList->prev = info;
+    }
+    MemInfoList = info;
+#endif /* GUI_CFG_MEM_DEBUG */
+}
+
+/**
+ * \brief           Remove block from tag counters and list of allocated blocks
+ * \param[in]       info: Block information
+ */
+static void
+mem_info_remove(mem_info_t* info) {
+    gui_mem_tag_stat_t* stat = &MemTagStats[info->tag];
+
+    stat->used -= info->size;
+    stat->blocks--;
+#if GUI_CFG_MEM_DEBUG
+    if (info->prev != NULL) {
+        info->prev->next = info->next;
+    } else {
+        MemInfoList = info->next;
+    }
+    if (info->next != NULL) {
+        info->next->prev = info->prev;
+    }
+#endif /* GUI_CFG_MEM_DEBUG */
+}
+
+#else /* GUI_CFG_MEM_STATS || __DOXYGEN__ */
+#define MEM_INFO_SIZE               0
+#endif /* !(GUI_CFG_MEM_STATS || __DOXYGEN__) */
+
+/**
+ * \brief           Allocate memory for subsystem
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Allocation tag
+ * \return          Allocated memory on success, `NULL` otherwise
+ */
+static void*
+mem_alloc_tag(size_t size, gui_mem_tag_t tag) {
+#if GUI_CFG_MEM_STATS
+    mem_info_t* info;
+#endif /* GUI_CFG_MEM_STATS */
+
+    if ((size_t)tag >= GUI_MEM_TAG_END) {
+        tag = GUI_MEM_TAG_OTHER;
+    }
+#if GUI_CFG_MEM_STATS
+    info = size ? mem_backend_alloc(MEM_INFO_SIZE + size, MemTagClass[tag]) : NULL;
+    if (info != NULL) {
+        info->size = size;
+        info->tag = (uint8_t)tag;
+#if GUI_CFG_MEM_DEBUG
+        info->file = MemCallsiteFile;
+        info->line = MemCallsiteLine;
+        info->time = gui_sys_now();
+#endif /* GUI_CFG_MEM_DEBUG */
+        mem_info_add(info);
+    } else {
+        MemTagStats[tag].failed++;
+    }
+#if GUI_CFG_MEM_DEBUG
+    MemCallsiteFile = NULL;                         /* Call site is valid for one allocation only */
+    MemCallsiteLine = 0;
+#endif /* GUI_CFG_MEM_DEBUG */
+    return info != NULL ? MEM_INFO_TOPTR(info) : NULL;
+#else /* GUI_CFG_MEM_STATS */
+    return mem_backend_alloc(size, MemTagClass[tag]);
+#endif /* !GUI_CFG_MEM_STATS */
+}
+
 /**
  * \brief           Allocate memory of specific size
  * \note            This function is private and may be called only when OS protection is active
@@ -367,32 +1232,45 @@ mem_getminfree(void) {
  */
 void*
 gui_mem_alloc(uint32_t size) {
-    void* ptr;
-
-#if GUI_CFG_USE_MEM
-    ptr = mem_alloc(size);                          /* Allocate memory and return pointer */
-#else /* GUI_CFG_USE_MEM */
-    ptr = malloc(size);
-#endif /* !GUI_CFG_USE_MEM */
-
-    return ptr;
+    return mem_alloc_tag(size, GUI_MEM_TAG_OTHER);
 }
 
 /**
  * \brief           Allocate memory of specific size
  * \note            After new memory is allocated, content of old one is copied to new memory
+ * \note            Allocation tag of memory is not changed
  * \param[in]       ptr: Pointer to current allocated memory to resize, returned using \ref gui_mem_alloc, \ref gui_mem_calloc or \ref gui_mem_realloc functions
  * \param[in]       size: Number of bytes to allocate on new memory
  * \return          Allocated memory on success, `NULL` otherwise
  */
 void*
 gui_mem_realloc(void* ptr, size_t size) {
-#if GUI_CFG_USE_MEM
-    ptr = mem_realloc(ptr, size);                   /* Reallocate and return pointer */
-#else /* GUI_CFG_USE_MEM */
-    ptr = realloc(ptr, size);
-#endif /* GUI_CFG_USE_MEM */
+#if GUI_CFG_MEM_STATS
+    mem_info_t *info, *new_info;
+
+    if (ptr == NULL) {
+        return mem_alloc_tag(size, GUI_MEM_TAG_OTHER);
+    }
+    info = MEM_INFO_FROMPTR(ptr);
+    mem_info_remove(info);
+    new_info = size ? mem_backend_realloc(info, MEM_INFO_SIZE + size) : NULL;
+    if (new_info != NULL) {                         /* Information is copied together with user data */
+        new_info->size = size;
+        mem_info_add(new_info);
+        ptr = MEM_INFO_TOPTR(new_info);
+    } else {
+        MemTagStats[info->tag].failed++;
+        mem_info_add(info);                         /* Old memory is still valid */
+        ptr = NULL;
+    }
+#if GUI_CFG_MEM_DEBUG
+    MemCallsiteFile = NULL;
+    MemCallsiteLine = 0;
+#endif /* GUI_CFG_MEM_DEBUG */
     return ptr;
+#else /* GUI_CFG_MEM_STATS */
+    return mem_backend_realloc(ptr, size);
+#endif /* !GUI_CFG_MEM_STATS */
 }
 
 /**
@@ -403,13 +1281,25 @@ gui_mem_realloc(void* ptr, size_t size) {
  */
 void*
 gui_mem_calloc(size_t num, size_t size) {
+    return gui_mem_calloc_tag(num, size, GUI_MEM_TAG_OTHER);
+}
+
+/**
+ * \brief           Allocate memory for subsystem and set memory to zero
+ * \param[in]       num: Number of elements to allocate
+ * \param[in]       size: Size of each element
+ * \param[in]       tag: Allocation tag, used for memory statistics
+ * \return          Allocated memory on success, `NULL` otherwise
+ * \sa              gui_mem_gettagstat
+ */
+void*
+gui_mem_calloc_tag(size_t num, size_t size, gui_mem_tag_t tag) {
     void* ptr;
+    size_t tot_len = num * size;
 
-#if GUI_CFG_USE_MEM
-    ptr = mem_calloc(num, size);                    /* Allocate memory and clear it to 0. Then return pointer */
-#else /* GUI_CFG_USE_MEM */
-    ptr = calloc(num, size);
-#endif /* !GUI_CFG_USE_MEM */
+    if ((ptr = mem_alloc_tag(tot_len, tag)) != NULL) {  /* Try to allocate memory */
+        memset(ptr, 0x00, tot_len);                 /* Reset entire memory */
+    }
     return ptr;
 }
 
@@ -419,11 +1309,596 @@ gui_mem_calloc(size_t num, size_t size) {
  */
 void
 gui_mem_free(void* ptr) {
-#if GUI_CFG_USE_MEM
-    mem_free(ptr);                                  /* Free already allocated memory */
-#else /* GUI_CFG_USE_MEM */
-    free(ptr);
-#endif /* !GUI_CFG_USE_MEM */
+#if GUI_CFG_MEM_STATS
+    if (ptr == NULL) {
+        return;
+    }
+    ptr = MEM_INFO_FROMPTR(ptr);
+    mem_info_remove(ptr);
+#endif /* GUI_CFG_MEM_STATS */
+    mem_backend_free(ptr);                          /* Free already allocated memory */
+}
+
+#if GUI_CFG_MEM_POOL_CLASSES || __DOXYGEN__
+
+/**
+ * \brief           Get memory pool for specific object size
+ * \param[in]       size: Object size in units of bytes
+ * \param[in]       create: Set to `1` to use new class if pool for size does not exist yet
+ * \return          Pointer to pool on success, `NULL` otherwise
+ */
+static mem_pool_t*
+mem_pool_get(size_t size, uint8_t create) {
+    size_t i;
+    
+    for (i = 0; i < GUI_CFG_MEM_POOL_CLASSES && MemPools[i].size; i++) {
+        if (MemPools[i].size == size) {
+            return &MemPools[i];
+        }
+    }
+    if (create && i < GUI_CFG_MEM_POOL_CLASSES) {   /* Use first free class */
+        MemPools[i].size = size;
+        return &MemPools[i];
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Remove chunk from list of chunks in pool
+ * \param[in]       pool: Memory pool
+ * \param[in]       chunk: Chunk to remove
+ */
+static void
+mem_pool_chunk_unlink(mem_pool_t* pool, mem_pool_chunk_t* chunk) {
+    if (chunk->prev != NULL) {
+        chunk->prev->next = chunk->next;
+    } else {
+        pool->first = chunk->next;
+    }
+    if (chunk->next != NULL) {
+        chunk->next->prev = chunk->prev;
+    } else {
+        pool->last = chunk->prev;
+    }
+    chunk->next = chunk->prev = NULL;
+}
+
+/**
+ * \brief           Add chunk to the beginning or to the end of list of chunks in pool
+ * \param[in]       pool: Memory pool
+ * \param[in]       chunk: Chunk to add
+ * \param[in]       front: Set to `1` to add chunk to the beginning, `0` to add it to the end
+ */
+static void
+mem_pool_chunk_link(mem_pool_t* pool, mem_pool_chunk_t* chunk, uint8_t front) {
+    if (front) {
+        chunk->prev = NULL;
+        chunk->next = pool->first;
+        if (pool->first != NULL) {
+            pool->first->prev = chunk;
+        } else {
+            pool->last = chunk;
+        }
+        pool->first = chunk;
+    } else {
+        chunk->next = NULL;
+        chunk->prev = pool->last;
+        if (pool->last != NULL) {
+            pool->last->next = chunk;
+        } else {
+            pool->first = chunk;
+        }
+        pool->last = chunk;
+    }
+}
+
+/**
+ * \brief           Allocate new chunk of objects for pool from memory
+ * \param[in]       pool: Memory pool
+ * \return          New chunk on success, `NULL` otherwise
+ */
+static mem_pool_chunk_t*
+mem_pool_chunk_new(mem_pool_t* pool) {
+    mem_pool_chunk_t* chunk;
+    uint8_t* obj;
+    size_t i;
+    
+    chunk = mem_alloc_tag(MEM_POOL_CHUNK_METASIZE + GUI_CFG_MEM_POOL_CHUNK_OBJECTS * MEM_POOL_OBJ_SIZE(pool->size), GUI_MEM_TAG_WIDGET);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->free = NULL;
+    chunk->used = 0;
+    
+    /* Create list of free objects, first object in memory is first free */
+    obj = ((uint8_t *)chunk) + MEM_POOL_CHUNK_METASIZE + GUI_CFG_MEM_POOL_CHUNK_OBJECTS * MEM_POOL_OBJ_SIZE(pool->size);
+    for (i = 0; i < GUI_CFG_MEM_POOL_CHUNK_OBJECTS; i++) {
+        obj -= MEM_POOL_OBJ_SIZE(pool->size);
+        *(mem_pool_chunk_t **)obj = chunk;          /* Set chunk of object */
+        MEM_POOL_OBJ_NEXT(obj + MEM_POOL_OBJ_METASIZE) = chunk->free;
+        chunk->free = obj + MEM_POOL_OBJ_METASIZE;
+    }
+    
+    mem_pool_chunk_link(pool, chunk, 1);            /* Chunk has free objects */
+    pool->chunks++;
+    pool->chunks_empty++;
+    return chunk;
+}
+
+#endif /* GUI_CFG_MEM_POOL_CLASSES || __DOXYGEN__ */
+
+/**
+ * \brief           Allocate object from memory pool for objects of specific size and set memory to zero
+ *
+ *                  Pool for object size is grown in chunks of \ref GUI_CFG_MEM_POOL_CHUNK_OBJECTS objects when necessary.
+ *                  When there is no pool available for requested size, object is allocated directly from memory.
+ *
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       size: Object size in units of bytes
+ * \return          Allocated memory on success, `NULL` otherwise
+ * \sa              gui_mem_pool_free
+ */
+void*
+gui_mem_pool_alloc(size_t size) {
+#if GUI_CFG_MEM_POOL_CLASSES
+    mem_pool_t* pool;
+    mem_pool_chunk_t* chunk;
+    void* ptr;
+    
+    pool = mem_pool_get(size, 1);
+    if (pool == NULL) {                             /* No pool for this size */
+        return gui_mem_calloc_tag(1, size, GUI_MEM_TAG_WIDGET);
+    }
+    
+    /* Chunks with free objects are first in list */
+    chunk = pool->first;
+    if (chunk == NULL || chunk->free == NULL) {
+        chunk = mem_pool_chunk_new(pool);
+        if (chunk == NULL) {
+            return NULL;
+        }
+    }
+    
+    ptr = chunk->free;                              /* Get first free object */
+    chunk->free = MEM_POOL_OBJ_NEXT(ptr);
+    if (!chunk->used++) {
+        pool->chunks_empty--;
+    }
+    if (chunk->free == NULL && chunk != pool->last) {   /* Move full chunk to the end */
+        mem_pool_chunk_unlink(pool, chunk);
+        mem_pool_chunk_link(pool, chunk, 0);
+    }
+    
+    if (++pool->used > pool->max_used) {
+        pool->max_used = pool->used;
+    }
+    memset(ptr, 0x00, size);                        /* Reset entire memory */
+    return ptr;
+#else /* GUI_CFG_MEM_POOL_CLASSES */
+    return gui_mem_calloc_tag(1, size, GUI_MEM_TAG_WIDGET);
+#endif /* !GUI_CFG_MEM_POOL_CLASSES */
+}
+
+/**
+ * \brief           Free object previously allocated with \ref gui_mem_pool_alloc
+ *
+ *                  When chunk of pool has no allocated objects anymore and pool already has one empty chunk,
+ *                  memory of chunk is returned back to memory.
+ *
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       ptr: Pointer to object to free
+ * \param[in]       size: Object size in units of bytes, the same as used on allocation
+ */
+void
+gui_mem_pool_free(void* ptr, size_t size) {
+#if GUI_CFG_MEM_POOL_CLASSES
+    mem_pool_t* pool;
+    mem_pool_chunk_t* chunk;
+    
+    if (ptr == NULL) {
+        return;
+    }
+    pool = mem_pool_get(size, 0);
+    if (pool == NULL) {                             /* Object was not allocated from pool */
+        gui_mem_free(ptr);
+        return;
+    }
+    
+    chunk = MEM_POOL_OBJ_CHUNK(ptr);                /* Get chunk of object */
+    if (chunk->free == NULL && chunk != pool->first) {  /* Chunk is not full anymore, move it to the beginning */
+        mem_pool_chunk_unlink(pool, chunk);
+        mem_pool_chunk_link(pool, chunk, 1);
+    }
+    MEM_POOL_OBJ_NEXT(ptr) = chunk->free;
+    chunk->free = ptr;
+    pool->used--;
+    
+    if (!--chunk->used) {
+        if (pool->chunks_empty) {                   /* Keep only one empty chunk in pool */
+            mem_pool_chunk_unlink(pool, chunk);
+            gui_mem_free(chunk);
+            pool->chunks--;
+        } else {
+            pool->chunks_empty++;
+        }
+    }
+#else /* GUI_CFG_MEM_POOL_CLASSES */
+    GUI_UNUSED(size);
+    gui_mem_free(ptr);
+#endif /* !GUI_CFG_MEM_POOL_CLASSES */
+}
+
+/**
+ * \brief           Get statistics of memory pool
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       index: Pool index, from `0` to \ref GUI_CFG_MEM_POOL_CLASSES - 1
+ * \param[out]      stat: Pointer to output statistics structure
+ * \return          `1` on success, `0` if pool with index is not used
+ */
+uint8_t
+gui_mem_pool_getstat(size_t index, gui_mem_pool_stat_t* stat) {
+#if GUI_CFG_MEM_POOL_CLASSES
+    mem_pool_t* pool;
+    
+    if (index >= GUI_CFG_MEM_POOL_CLASSES || !MemPools[index].size || stat == NULL) {
+        return 0;
+    }
+    pool = &MemPools[index];
+    stat->size = pool->size;
+    stat->used = pool->used;
+    stat->max_used = pool->max_used;
+    stat->total = pool->chunks * GUI_CFG_MEM_POOL_CHUNK_OBJECTS;
+    stat->chunks = pool->chunks;
+    return 1;
+#else /* GUI_CFG_MEM_POOL_CLASSES */
+    GUI_UNUSED(index);
+    GUI_UNUSED(stat);
+    return 0;
+#endif /* !GUI_CFG_MEM_POOL_CLASSES */
+}
+
+/**
+ * \brief           Header of frame memory block
+ */
+typedef struct mem_frame_block {
+    struct mem_frame_block* next;                   /*!< Next block allocated from main memory, not used in arena */
+    size_t size;                                    /*!< Size of user memory in units of bytes */
+} mem_frame_block_t;
+
+#define MEM_FRAME_BLOCK_METASIZE    MEM_ALIGN(sizeof(mem_frame_block_t))
+#define MEM_FRAME_BLOCK_FROMPTR(ptr)    ((mem_frame_block_t *)(((uint8_t *)(ptr)) - MEM_FRAME_BLOCK_METASIZE))
+#define MEM_FRAME_ARENA_SIZE        MEM_ALIGN(GUI_CFG_MEM_FRAME_SIZE)
+
+#if GUI_CFG_MEM_FRAME_SIZE
+static uint8_t* MemFrameArena;                      /* Arena memory, allocated on first use */
+static size_t MemFrameArenaUsed;                    /* Number of used bytes in arena */
+#endif /* GUI_CFG_MEM_FRAME_SIZE */
+static mem_frame_block_t* MemFrameBlocks;           /* Blocks allocated from main memory when arena is full */
+static size_t MemFrameUsed;                         /* Number of bytes allocated in current frame */
+static size_t MemFrameMaxUsed;                      /* Maximal number of bytes allocated in single frame */
+
+/**
+ * \brief           Allocate memory valid until the end of current redraw
+ *
+ *                  Memory is taken from frame arena when possible, otherwise from main memory.
+ *                  All frame memory is released with \ref gui_mem_frame_reset after redraw,
+ *                  so widgets can use it as scratch memory in \ref GUI_EVT_DRAW event without freeing it.
+ *
+ * \note            Memory is not set to zero
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       size: Number of bytes to allocate
+ * \return          Allocated memory on success, `NULL` otherwise
+ * \sa              gui_mem_frame_free
+ */
+void*
+gui_mem_frame_alloc(size_t size) {
+    mem_frame_block_t* block = NULL;
+
+    if (!size) {
+        return NULL;
+    }
+    size = MEM_ALIGN(size);
+
+#if GUI_CFG_MEM_FRAME_SIZE
+    if (MemFrameArena == NULL) {                    /* Arena is allocated once and kept */
+        MemFrameArena = mem_alloc_tag(MEM_FRAME_ARENA_SIZE, GUI_MEM_TAG_LAYER);
+    }
+    if (MemFrameArena != NULL && (MEM_FRAME_BLOCK_METASIZE + size) <= (MEM_FRAME_ARENA_SIZE - MemFrameArenaUsed)) {
+        block = (mem_frame_block_t *)(MemFrameArena + MemFrameArenaUsed);
+        block->next = NULL;
+        MemFrameArenaUsed += MEM_FRAME_BLOCK_METASIZE + size;
+    }
+#endif /* GUI_CFG_MEM_FRAME_SIZE */
+    if (block == NULL) {                            /* Use main memory until the end of frame */
+        block = mem_alloc_tag(MEM_FRAME_BLOCK_METASIZE + size, GUI_MEM_TAG_LAYER);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->next = MemFrameBlocks;
+        MemFrameBlocks = block;
+    }
+    block->size = size;
+
+    MemFrameUsed += size;
+    if (MemFrameUsed > MemFrameMaxUsed) {
+        MemFrameMaxUsed = MemFrameUsed;
+    }
+    return ((uint8_t *)block) + MEM_FRAME_BLOCK_METASIZE;
+}
+
+/**
+ * \brief           Free frame memory before the end of redraw
+ *
+ *                  Last block allocated in arena is returned to arena immediately,
+ *                  so nested allocations freed in reverse order reuse the same memory.
+ *                  Other blocks in arena are released at the end of frame.
+ *
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       ptr: Pointer to memory returned by \ref gui_mem_frame_alloc
+ */
+void
+gui_mem_frame_free(void* ptr) {
+    mem_frame_block_t *block, **prev;
+
+    if (ptr == NULL) {
+        return;
+    }
+    block = MEM_FRAME_BLOCK_FROMPTR(ptr);
+
+#if GUI_CFG_MEM_FRAME_SIZE
+    if (MemFrameArena != NULL && (uint8_t *)block >= MemFrameArena && (uint8_t *)block < (MemFrameArena + MEM_FRAME_ARENA_SIZE)) {
+        if (((uint8_t *)ptr) + block->size == MemFrameArena + MemFrameArenaUsed) {  /* Last block in arena */
+            MemFrameArenaUsed -= MEM_FRAME_BLOCK_METASIZE + block->size;
+            MemFrameUsed -= block->size;
+        }
+        return;
+    }
+#endif /* GUI_CFG_MEM_FRAME_SIZE */
+    for (prev = &MemFrameBlocks; *prev != NULL; prev = &(*prev)->next) {
+        if (*prev == block) {
+            *prev = block->next;
+            MemFrameUsed -= block->size;
+            gui_mem_free(block);
+            break;
+        }
+    }
+}
+
+/**
+ * \brief           Release all frame memory
+ * \note            Called by library after every redraw
+ * \note            This function is private and may be called only when OS protection is active
+ */
+void
+gui_mem_frame_reset(void) {
+    mem_frame_block_t* block;
+
+    while (MemFrameBlocks != NULL) {
+        block = MemFrameBlocks;
+        MemFrameBlocks = block->next;
+        gui_mem_free(block);
+    }
+#if GUI_CFG_MEM_FRAME_SIZE
+    MemFrameArenaUsed = 0;
+#endif /* GUI_CFG_MEM_FRAME_SIZE */
+    MemFrameUsed = 0;
+}
+
+/**
+ * \brief           Get maximal number of bytes allocated in single frame
+ *
+ *                  When value is larger than \ref GUI_CFG_MEM_FRAME_SIZE,
+ *                  part of frame memory was allocated from main memory
+ *
+ * \note            Block headers are not included
+ * \note            This function is private and may be called only when OS protection is active
+ * \return          High-water mark of frame memory in units of bytes
+ */
+size_t
+gui_mem_frame_getmaxused(void) {
+    return MemFrameMaxUsed;
+}
+
+#if GUI_CFG_MEM_COMPACT || __DOXYGEN__
+
+/**
+ * \brief           Header of movable memory block, placed before user memory
+ */
+typedef struct mem_movable {
+    struct mem_movable* next;                       /*!< Next movable block */
+    struct mem_movable* prev;                       /*!< Previous movable block */
+    void** owner;                                   /*!< Pointer to the only variable pointing to user memory */
+} mem_movable_t;
+
+#define MEM_MOVABLE_SIZE            MEM_ALIGN(sizeof(mem_movable_t))
+#define MEM_MOVABLE_FROMPTR(ptr)    ((mem_movable_t *)(((uint8_t *)(ptr)) - MEM_MOVABLE_SIZE))
+#define MEM_MOVABLE_TOPTR(mv)       ((void *)(((uint8_t *)(mv)) + MEM_MOVABLE_SIZE))
+
+static mem_movable_t* MemMovableList;               /* List of all movable blocks */
+static mem_movable_t* MemMovableNext;               /* Next block to check in compaction */
+
+/**
+ * \brief           Update list and owner after movable block header was moved
+ * \param[in]       mv: New header address
+ * \param[in]       old: Old header address or `NULL` for new block
+ */
+static void
+mem_movable_relink(mem_movable_t* mv, mem_movable_t* old) {
+    if (mv->prev != NULL) {
+        mv->prev->next = mv;
+    } else {
+        MemMovableList = mv;
+    }
+    if (mv->next != NULL) {
+        mv->next->prev = mv;
+    }
+    if (old != NULL && MemMovableNext == old) {
+        MemMovableNext = mv;
+    }
+    *mv->owner = MEM_MOVABLE_TOPTR(mv);
+}
+
+/**
+ * \brief           Remove movable block from list
+ * \param[in]       mv: Block header
+ */
+static void
+mem_movable_unlink(mem_movable_t* mv) {
+    if (mv->prev != NULL) {
+        mv->prev->next = mv->next;
+    } else {
+        MemMovableList = mv->next;
+    }
+    if (mv->next != NULL) {
+        mv->next->prev = mv->prev;
+    }
+    if (MemMovableNext == mv) {
+        MemMovableNext = mv->next;
+    }
+}
+
+#endif /* GUI_CFG_MEM_COMPACT || __DOXYGEN__ */
+
+/**
+ * \brief           Allocate movable memory and set it to zero
+ *
+ *                  Movable memory may be moved to lower address by \ref gui_mem_compact
+ *                  to merge free memory. Variable pointed to by `owner` is updated on every move,
+ *                  so it must be the only pointer to memory, kept outside movable memory.
+ *
+ * \note            Memory must be resized with \ref gui_mem_movable_realloc and freed with \ref gui_mem_movable_free
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       owner: Pointer to variable holding pointer to memory. It is set to allocated memory or `NULL`
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Allocation tag, used for memory statistics
+ * \return          Allocated memory on success, `NULL` otherwise
+ */
+void*
+gui_mem_movable_alloc(void** owner, size_t size, gui_mem_tag_t tag) {
+#if GUI_CFG_MEM_COMPACT
+    mem_movable_t* mv;
+
+    if (owner == NULL) {
+        return NULL;
+    }
+    *owner = NULL;
+    mv = size ? mem_alloc_tag(MEM_MOVABLE_SIZE + size, tag) : NULL;
+    if (mv != NULL) {
+        memset(MEM_MOVABLE_TOPTR(mv), 0x00, size);
+        mv->owner = owner;
+        mv->prev = NULL;
+        mv->next = MemMovableList;
+        mem_movable_relink(mv, NULL);               /* Add to beginning of list and set owner */
+    }
+    return *owner;
+#else /* GUI_CFG_MEM_COMPACT */
+    if (owner == NULL) {
+        return NULL;
+    }
+    *owner = gui_mem_calloc_tag(1, size, tag);
+    return *owner;
+#endif /* !GUI_CFG_MEM_COMPACT */
+}
+
+/**
+ * \brief           Resize movable memory
+ * \note            When `owner` points to `NULL`, new memory is allocated
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       owner: Pointer to variable holding pointer to memory,
+ *                      returned using \ref gui_mem_movable_alloc or \ref gui_mem_movable_realloc functions.
+ *                      It is updated on success and not modified on failure
+ * \param[in]       size: Number of bytes to allocate on new memory
+ * \return          Allocated memory on success, `NULL` otherwise
+ */
+void*
+gui_mem_movable_realloc(void** owner, size_t size) {
+    void* ptr;
+
+    if (owner == NULL || !size) {
+        return NULL;
+    }
+    if (*owner == NULL) {
+        return gui_mem_movable_alloc(owner, size, GUI_MEM_TAG_OTHER);
+    }
+#if GUI_CFG_MEM_COMPACT
+    ptr = gui_mem_realloc(MEM_MOVABLE_FROMPTR(*owner), MEM_MOVABLE_SIZE + size);
+    if (ptr != NULL) {
+        mem_movable_relink(ptr, MEM_MOVABLE_FROMPTR(*owner));   /* Header is copied together with user data */
+    }
+#else /* GUI_CFG_MEM_COMPACT */
+    ptr = gui_mem_realloc(*owner, size);
+    if (ptr != NULL) {
+        *owner = ptr;
+    }
+#endif /* !GUI_CFG_MEM_COMPACT */
+    return ptr != NULL ? *owner : NULL;
+}
+
+/**
+ * \brief           Free movable memory
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       owner: Pointer to variable holding pointer to memory. It is set to `NULL`
+ */
+void
+gui_mem_movable_free(void** owner) {
+    if (owner == NULL || *owner == NULL) {
+        return;
+    }
+#if GUI_CFG_MEM_COMPACT
+    mem_movable_unlink(MEM_MOVABLE_FROMPTR(*owner));
+    gui_mem_free(MEM_MOVABLE_FROMPTR(*owner));
+#else /* GUI_CFG_MEM_COMPACT */
+    gui_mem_free(*owner);
+#endif /* !GUI_CFG_MEM_COMPACT */
+    *owner = NULL;
+}
+
+/**
+ * \brief           Move movable memory blocks to lower addresses to merge free memory
+ *
+ *                  Every checked block, placed directly after free memory, is moved down
+ *                  and free memory is merged with memory after the block.
+ *                  Next call continues with blocks not checked yet.
+ *
+ * \note            Called by library in every \ref gui_process call
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       max_blocks: Maximal number of blocks to check in single call
+ * \return          Number of moved blocks
+ */
+size_t
+gui_mem_compact(size_t max_blocks) {
+#if GUI_CFG_MEM_COMPACT
+    mem_movable_t *mv, *new_mv;
+    uint8_t* ptr;
+    size_t moved = 0;
+
+    for (; max_blocks && MemMovableList != NULL; max_blocks--) {
+        if (MemMovableNext == NULL) {               /* Start again from beginning of list */
+            MemMovableNext = MemMovableList;
+        }
+        mv = MemMovableNext;
+        MemMovableNext = mv->next;
+
+        ptr = ((uint8_t *)mv) - MEM_INFO_SIZE;      /* Memory returned by allocator */
+#if GUI_CFG_MEM_STATS
+        mem_info_remove((mem_info_t *)ptr);
+#endif /* GUI_CFG_MEM_STATS */
+        if ((ptr = mem_backend_slide(ptr)) != NULL) {
+            new_mv = (mem_movable_t *)(ptr + MEM_INFO_SIZE);
+            mem_movable_relink(new_mv, mv);
+            moved++;
+        } else {
+            ptr = ((uint8_t *)mv) - MEM_INFO_SIZE;
+        }
+#if GUI_CFG_MEM_STATS
+        mem_info_add((mem_info_t *)ptr);
+#endif /* GUI_CFG_MEM_STATS */
+    }
+    return moved;
+#else /* GUI_CFG_MEM_COMPACT */
+    GUI_UNUSED(max_blocks);
+    return 0;
+#endif /* !GUI_CFG_MEM_COMPACT */
 }
 
 /**
@@ -456,6 +1931,147 @@ gui_mem_getminfree(void) {
     return mem_getminfree();                        /* Get minimal number of bytes ever available for allocation */
 }
 
+/**
+ * \brief           Get size of largest free block
+ *
+ *                  When largest block is much smaller than total free memory,
+ *                  allocations fail because memory is fragmented
+ *
+ * \note            This function is private and may be called only when OS protection is active
+ * \note            TLSF allocator may need slightly larger block than requested size to allocate in constant time
+ * \return          Number of bytes of largest free block or `0` if not available
+ */
+size_t
+gui_mem_getlargestfree(void) {
+#if GUI_CFG_USE_MEM
+    size_t largest = 0;
+
+    mem_getfreeblocks(&largest, NULL, 0);
+    return largest > MEM_INFO_SIZE ? largest - MEM_INFO_SIZE : 0;
+#else /* GUI_CFG_USE_MEM */
+    return 0;
+#endif /* !GUI_CFG_USE_MEM */
+}
+
+/**
+ * \brief           Get histogram of free block sizes
+ *
+ *                  Entry `0` counts blocks smaller than `32` bytes,
+ *                  entry `i` counts blocks from `16 << i` to `(32 << i) - 1` bytes
+ *                  and last entry counts all larger blocks too
+ *
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[out]      hist: Array for histogram or `NULL` to count blocks only
+ * \param[in]       len: Number of entries in array
+ * \return          Number of free blocks
+ */
+size_t
+gui_mem_getfreehistogram(size_t* hist, size_t len) {
+#if GUI_CFG_USE_MEM
+    size_t largest = 0;
+
+    if (hist != NULL) {
+        memset(hist, 0x00, sizeof(*hist) * len);
+    }
+    return mem_getfreeblocks(&largest, hist, len);
+#else /* GUI_CFG_USE_MEM */
+    GUI_UNUSED(hist);
+    GUI_UNUSED(len);
+    return 0;
+#endif /* !GUI_CFG_USE_MEM */
+}
+
+/**
+ * \brief           Get memory usage statistics of allocation tag
+ * \note            Available only when \ref GUI_CFG_MEM_STATS is enabled
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       tag: Allocation tag
+ * \param[out]      stat: Pointer to output statistics structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_mem_gettagstat(gui_mem_tag_t tag, gui_mem_tag_stat_t* stat) {
+#if GUI_CFG_MEM_STATS
+    if ((size_t)tag >= GUI_MEM_TAG_END || stat == NULL) {
+        return 0;
+    }
+    *stat = MemTagStats[tag];
+    return 1;
+#else /* GUI_CFG_MEM_STATS */
+    GUI_UNUSED(tag);
+    GUI_UNUSED(stat);
+    return 0;
+#endif /* !GUI_CFG_MEM_STATS */
+}
+
+/**
+ * \brief           Set allocation class used for new allocations of tag
+ * \note            When there is no free memory in regions of class,
+ *                  regions of other classes are used in fallback order
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       tag: Allocation tag
+ * \param[in]       mem_class: Allocation class. This parameter can be a value of \ref gui_mem_class_t enumeration
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_mem_settagclass(gui_mem_tag_t tag, gui_mem_class_t mem_class) {
+    if ((size_t)tag >= GUI_MEM_TAG_END || (size_t)mem_class >= GUI_MEM_CLASS_END) {
+        return 0;
+    }
+    MemTagClass[tag] = (uint8_t)mem_class;
+    return 1;
+}
+
+/**
+ * \brief           Set file and line for next allocation
+ * \note            Called by allocation macros when \ref GUI_CFG_MEM_DEBUG is enabled
+ * \param[in]       file: File name
+ * \param[in]       line: Line in file
+ */
+void
+gui_mem_setcallsite(const char* file, uint32_t line) {
+#if GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG
+    MemCallsiteFile = file;
+    MemCallsiteLine = line;
+#else /* GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG */
+    GUI_UNUSED(file);
+    GUI_UNUSED(line);
+#endif /* !(GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG) */
+}
+
+/**
+ * \brief           Print all allocated blocks older than specific age with \ref GUI_DEBUG
+ *
+ *                  Blocks which stay allocated long after screen was closed are usually leaked.
+ *
+ * \note            Available only when \ref GUI_CFG_MEM_STATS and \ref GUI_CFG_MEM_DEBUG are enabled
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       min_age: Minimal age of block in units of milliseconds. Set to `0` to print all blocks
+ * \return          Number of printed blocks
+ */
+size_t
+gui_mem_dumpblocks(uint32_t min_age) {
+#if GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG
+    mem_info_t* info;
+    uint32_t now = gui_sys_now(), age;
+    size_t count = 0;
+
+    for (info = MemInfoList; info != NULL; info = info->next) {
+        age = now - info->time;
+        if (age >= min_age) {
+            GUI_DEBUG("%p: %u bytes, tag %u, age %u ms, %s:%u\r\n",
+                MEM_INFO_TOPTR(info), (unsigned)info->size, (unsigned)info->tag, (unsigned)age,
+                info->file != NULL ? info->file : "?", (unsigned)info->line);
+            count++;
+        }
+    }
+    return count;
+#else /* GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG */
+    GUI_UNUSED(min_age);
+    return 0;
+#endif /* !(GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG) */
+}
+
 /**
  * \brief           Assign memory region(s) for allocation functions
  * \note            You can allocate multiple regions by assigning start address and region size in units of bytes
@@ -115,7 +115,7 @@ gui_text_createcharentry(const gui_font_t* font, const gui_font_char_t* c) {
     memsize = GUI_MEM_ALIGN(sizeof(*entry));
     memDataSize = (size_t)c->x_size * (size_t)c->y_size;
     memsize += GUI_MEM_ALIGN(memDataSize);          /* Align memory before increase */
-    entry = GUI_MEMALLOC(memsize);                  /* Allocate memory for entry */
+    entry = GUI_MEMALLOC_TAG(memsize, GUI_MEM_TAG_GLYPH);   /* Allocate memory for entry */
     if (entry != NULL) {                            /* Allocation was successful */
         uint16_t i, x;
         uint8_t b, k, t;
@@ -34,14 +34,104 @@
 #define GUI_INTERNAL
 #include "gui/gui_private.h"
 #include "gui/gui_timer.h"
+#include "widget/gui_widget.h"
 #include "system/gui_sys.h"
 
 #define GUI_FLAG_TIMER_ACTIVE           ((uint16_t)(1 << 0UL))  /*!< Timer is active */
 #define GUI_FLAG_TIMER_PERIODIC         ((uint16_t)(1 << 1UL))  /*!< Timer will start from beginning after reach end */ 
-#define GUI_FLAG_TIMER_CALL             ((uint16_t)(1 << 2UL))  /*!< Call callback function on timer */
 
 #define guii_timer_isperiodic(t)        ((t)->flags & GUI_FLAG_TIMER_PERIODIC)
 
+/* Number of queue entries allocated at a time */
+#define TIMER_QUEUE_ALLOC_STEP          4
+
+/* Check if deadline of timer `a` is before deadline of timer `b`, time may overflow */
+#define timer_isbefore(a, b)            ((int32_t)((a)->deadline - (b)->deadline) < 0)
+
+/* Get time of next expiration when started now, period `0` expires on next processing */
+#define timer_getdeadline(t, time)      ((time) + GUI_MAX((t)->period, 1))
+
+/**
+ * \brief           Set timer to position in queue
+ * \param[in]       i: Position in queue
+ * \param[in]       t: Timer to set
+ */
+static void
+queue_set(size_t i, gui_timer_t* t) {
+    GUI.timers.queue[i] = t;
+    t->index = i;
+}
+
+/**
+ * \brief           Move timer towards beginning of queue until its parent expires earlier
+ * \param[in]       t: Timer in queue
+ */
+static void
+queue_siftup(gui_timer_t* t) {
+    size_t i = t->index, parent;
+
+    while (i > 0) {
+        parent = (i - 1) / 2;
+        if (!timer_isbefore(t, GUI.timers.queue[parent])) {
+            break;
+        }
+        queue_set(i, GUI.timers.queue[parent]);
+        i = parent;
+    }
+    queue_set(i, t);
+}
+
+/**
+ * \brief           Move timer towards end of queue until its children expire later
+ * \param[in]       t: Timer in queue
+ */
+static void
+queue_siftdown(gui_timer_t* t) {
+    size_t i = t->index, child;
+
+    while ((child = 2 * i + 1) < GUI.timers.count) {
+        if ((child + 1) < GUI.timers.count && timer_isbefore(GUI.timers.queue[child + 1], GUI.timers.queue[child])) {
+            child++;                                /* Use child with earlier deadline */
+        }
+        if (!timer_isbefore(GUI.timers.queue[child], t)) {
+            break;
+        }
+        queue_set(i, GUI.timers.queue[child]);
+        i = child;
+    }
+    queue_set(i, t);
+}
+
+/**
+ * \brief           Add timer to queue of active timers or update its position after deadline changed
+ * \param[in]       t: Timer with new deadline
+ */
+static void
+queue_update(gui_timer_t* t) {
+    if (!(t->flags & GUI_FLAG_TIMER_ACTIVE)) {      /* Add to the end of queue, space is reserved on create */
+        t->flags |= GUI_FLAG_TIMER_ACTIVE;
+        t->index = GUI.timers.count++;
+    }
+    queue_siftup(t);
+    queue_siftdown(t);
+}
+
+/**
+ * \brief           Remove timer from queue of active timers
+ * \param[in]       t: Active timer
+ */
+static void
+queue_remove(gui_timer_t* t) {
+    gui_timer_t* last;
+
+    t->flags &= ~GUI_FLAG_TIMER_ACTIVE;
+    last = GUI.timers.queue[--GUI.timers.count];    /* Move last timer to removed position */
+    if (last != t) {
+        last->index = t->index;
+        queue_update(last);
+    }
+}
+
 /**
  * \brief           Create new software timer
  * \note            This function is private and may be called only when OS protection is active
@@ -53,22 +143,32 @@
 gui_timer_t *
 guii_timer_create(uint16_t period, void (*callback)(gui_timer_t *), void* const params) {
     gui_timer_t* ptr;
+    gui_timer_t** queue;
     
-    ptr = GUI_MEMALLOC(sizeof(*ptr));               /* Allocate memory for timer */
+    /* Reserve space in queue, so every created timer can be started without allocation */
+    if (GUI.timers.timers == GUI.timers.size) {
+        if (GUI.timers.queue == NULL) {
+            queue = GUI_MEMALLOC_TAG(sizeof(*queue) * TIMER_QUEUE_ALLOC_STEP, GUI_MEM_TAG_TIMER);
+        } else {
+            queue = GUI_MEMREALLOC(GUI.timers.queue, sizeof(*queue) * (GUI.timers.size + TIMER_QUEUE_ALLOC_STEP));
+        }
+        if (queue == NULL) {
+            return NULL;
+        }
+        GUI.timers.queue = queue;
+        GUI.timers.size += TIMER_QUEUE_ALLOC_STEP;
+    }
+
+    ptr = GUI_MEMALLOC_TAG(sizeof(*ptr), GUI_MEM_TAG_TIMER);    /* Allocate memory for timer */
     if (ptr != NULL) {
         memset(ptr, 0x00, sizeof(*ptr));            /* Reset memory */
         
         ptr->period = period;                       /* Set period value */
-        ptr->counter = period;                      /* Set current counter value */
         ptr->callback = callback;                   /* Set callback */
         ptr->params = params;                       /* Timer custom parameters */
         ptr->flags = 0;                             /* Timer flags management */
         
-        gui_linkedlist_add_gen(&GUI.timers.list, (gui_linkedlist_t *)ptr);  /* Add timer to linked list */
-
-#if GUI_CFG_OS
-        gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);    /* Add new message to queue */
-#endif /* GUI_CFG_OS */
+        GUI.timers.timers++;                        /* Timer has reserved entry in queue */
     }
     return ptr;
 }
@@ -83,7 +183,10 @@ guii_timer_create(uint16_t period, void (*callback)(gui_timer_t *), void* const
 uint8_t
 guii_timer_remove(gui_timer_t** const t) {  
     GUI_ASSERTPARAMS(t != NULL && *t != NULL);  
-    gui_linkedlist_remove_gen(&GUI.timers.list, (gui_linkedlist_t *)(*t));  /* Remove timer from linked list */
+    if ((*t)->flags & GUI_FLAG_TIMER_ACTIVE) {      /* Remove timer from queue */
+        queue_remove(*t);
+    }
+    GUI.timers.timers--;
     GUI_MEMFREE(*t);                                /* Free memory for timer */
     *t = NULL;                                      /* Clear pointer */
     
@@ -99,12 +202,12 @@ guii_timer_remove(gui_timer_t** const t) {
 uint8_t
 guii_timer_start(gui_timer_t* const t) {
     GUI_ASSERTPARAMS(t);
-    t->counter = t->period;                         /* Reset counter to top value */
     t->flags &= ~GUI_FLAG_TIMER_PERIODIC;           /* Clear periodic flag */
-    t->flags |= GUI_FLAG_TIMER_ACTIVE;              /* Set active flag */
+    t->deadline = timer_getdeadline(t, gui_sys_now());  /* Set expiration time */
+    queue_update(t);                                /* Set active and order by deadline */
 
 #if GUI_CFG_OS
-    gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);        /* Add new message to queue */
+    gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);        /* Wakeup processing thread to use new deadline */
 #endif /* GUI_CFG_OS */
     
     return 1;
@@ -119,8 +222,13 @@ guii_timer_start(gui_timer_t* const t) {
 uint8_t
 guii_timer_startperiodic(gui_timer_t* const t) {
     GUI_ASSERTPARAMS(t);
-    t->counter = t->period;                         /* Reset counter to top value */
-    t->flags |= GUI_FLAG_TIMER_ACTIVE | GUI_FLAG_TIMER_PERIODIC;    /* Set active flag */
+    t->flags |= GUI_FLAG_TIMER_PERIODIC;            /* Set periodic flag */
+    t->deadline = timer_getdeadline(t, gui_sys_now());  /* Set expiration time */
+    queue_update(t);                                /* Set active and order by deadline */
+
+#if GUI_CFG_OS
+    gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);        /* Wakeup processing thread to use new deadline */
+#endif /* GUI_CFG_OS */
     
     return 1;
 }
@@ -134,8 +242,9 @@ guii_timer_startperiodic(gui_timer_t* const t) {
 uint8_t
 guii_timer_stop(gui_timer_t* const t) {
     GUI_ASSERTPARAMS(t);
-    t->counter = t->period;                         /* Reset counter to top value */
-    t->flags &= ~GUI_FLAG_TIMER_ACTIVE;             /* Clear active flag */
+    if (t->flags & GUI_FLAG_TIMER_ACTIVE) {         /* Remove from queue of active timers */
+        queue_remove(t);
+    }
     
     return 1;
 }
@@ -149,7 +258,10 @@ guii_timer_stop(gui_timer_t* const t) {
 uint8_t
 guii_timer_reset(gui_timer_t* const t) {
     GUI_ASSERTPARAMS(t);
-    t->counter = t->period;                         /* Clear and reset timer */
+    t->deadline = timer_getdeadline(t, gui_sys_now());  /* Count full period from now */
+    if (t->flags & GUI_FLAG_TIMER_ACTIVE) {
+        queue_update(t);                            /* Deadline moved later */
+    }
     
     return 1;
 }
@@ -157,48 +269,29 @@ guii_timer_reset(gui_timer_t* const t) {
 /**
  * \brief           Internal processing called by GUI library
  * \note            This function is private and may be called only when OS protection is active
- * \note            Processes all timers in loop and calls callback function if needed 
+ * \note            Calls callback functions of expired timers only, other timers are not checked
  */
 void
 guii_timer_process(void) {
     gui_timer_t* t;
-    volatile uint32_t time = gui_sys_now();         /* Get current time */
-    volatile uint32_t lastTime = GUI.timers.time;
-    uint32_t diff = time - lastTime;                /* Get difference in time */
-    
-    if (diff == 0) {                                /* No difference in time */
-        return;
-    }
+    uint32_t time = gui_sys_now();                  /* Get current time */
     
-    /* Process all software timers */
-    for (t = (gui_timer_t *)GUI.timers.list.first; t != NULL;
-        t = (gui_timer_t *)t->list.next) {
-        if (t->flags & GUI_FLAG_TIMER_CALL) {       /* Counter is set to 0, process callback */
-            t->flags &= ~GUI_FLAG_TIMER_CALL;       /* Clear timer flag */
-            if (!guii_timer_isperiodic(t)) {        /* If timer is not periodic */
-                guii_timer_stop(t);                 /* Stop timer */
-            }
-            if (t->callback != NULL) {              /* Process callback */
-                t->callback(t);                     /* Call user function */
+    /* Timer with earliest deadline is always first in queue */
+    while (GUI.timers.count && (int32_t)(time - GUI.timers.queue[0]->deadline) >= 0) {
+        t = GUI.timers.queue[0];
+        if (guii_timer_isperiodic(t)) {             /* Schedule next period */
+            t->deadline += GUI_MAX(t->period, 1);
+            if ((int32_t)(time - t->deadline) >= 0) {   /* Processing was late, skip missed periods */
+                t->deadline = timer_getdeadline(t, time);
             }
+            queue_siftdown(t);
+        } else {
+            queue_remove(t);                        /* Stop timer */
         }
-        
-        if (!(t->flags & GUI_FLAG_TIMER_ACTIVE)) {  /* Timer is not active */
-            continue;
-        }
-        if (t->counter >= diff) {                   /* Decrease counter value by zero */
-            t->counter -= diff;                     /* Try to decrease to 0 */
-            if (!t->counter) {
-                t->counter = t->period;             /* Set new period value */
-                t->flags |= GUI_FLAG_TIMER_CALL;    /* Set flag for timer callback next time */
-            }
-        } else {                                    /* Overflow mode */
-            t->counter = 0;                         /* Set new counter value */
-            t->flags |= GUI_FLAG_TIMER_CALL;        /* Set callback flag in next check */
+        if (t->callback != NULL) {                  /* Process callback */
+            t->callback(t);                         /* Call user function, it may start, stop or remove any timer */
         }
     }
-    
-    GUI.timers.time = time;                         /* Reset time */
 }
 
 /**
@@ -207,13 +300,247 @@ guii_timer_process(void) {
  */
 uint32_t
 guii_timer_getactivecount(void) {
-    uint32_t cnt = 0;
-    gui_timer_t* t;
-    for (t = (gui_timer_t *)gui_linkedlist_getnext_gen(&GUI.timers.list, NULL); t != NULL;
-        t = (gui_timer_t *)gui_linkedlist_getnext_gen(NULL, (gui_linkedlist_t *)t)) {
-        if ((t->flags & GUI_FLAG_TIMER_ACTIVE)) {
-            cnt++;
+    return (uint32_t)GUI.timers.count;
+}
+
+/**
+ * \brief           Get time until first active timer expires
+ * \note            This function is private and may be called only when OS protection is active
+ * \return          Number of milliseconds until next timer expiration, `0` if already expired
+ *                      or \ref GUI_TIMER_NO_DEADLINE when there is no active timer
+ */
+uint32_t
+guii_timer_gettimeout(void) {
+    int32_t diff;
+
+    if (!GUI.timers.count) {
+        return GUI_TIMER_NO_DEADLINE;
+    }
+    diff = (int32_t)(GUI.timers.queue[0]->deadline - gui_sys_now());
+    return diff > 0 ? (uint32_t)diff : 0;
+}
+
+/**
+ * \brief           Get animated value for elapsed time
+ * \param[in]       a: Running animation
+ * \param[in]       elapsed: Time since animation start, less than duration
+ * \return          Animated value
+ */
+static int32_t
+anim_getvalue(gui_anim_t* a, uint32_t elapsed) {
+    int32_t p, e;
+
+    p = (int32_t)((elapsed << 16) / a->duration);   /* Progress in 16.16 format, from 0 to 1 */
+    switch (a->ease) {
+        case GUI_ANIM_EASE_IN:
+            e = (int32_t)(((int64_t)p * p) >> 16);
+            break;
+        case GUI_ANIM_EASE_OUT:
+            e = 0x10000 - (int32_t)(((int64_t)(0x10000 - p) * (0x10000 - p)) >> 16);
+            break;
+        case GUI_ANIM_EASE_IN_OUT:
+            if (p < 0x8000) {
+                e = (int32_t)(((int64_t)p * p) >> 15);
+            } else {
+                e = 0x10000 - (int32_t)(((int64_t)(0x10000 - p) * (0x10000 - p)) >> 15);
+            }
+            break;
+        default:
+            e = p;
+            break;
+    }
+    return a->from + (int32_t)((((int64_t)a->to - a->from) * e) >> 16);
+}
+
+/**
+ * \brief           Set new value of animated property
+ * \param[in]       a: Animation
+ * \param[in]       value: New value
+ */
+static void
+anim_setvalue(gui_anim_t* a, int32_t value) {
+    if (*a->value != value) {
+        *a->value = value;
+        if (a->h != NULL) {
+            gui_widget_invalidate(a->h);            /* Redraw happens once per frame for all widgets */
+        }
+    }
+}
+
+/**
+ * \brief           Remove animation from list
+ * \param[in]       list: Pointer to first animation of list
+ * \param[in]       a: Animation to remove
+ */
+static void
+anim_unlink(gui_anim_t** list, gui_anim_t* a) {
+    for (; *list != NULL; list = &(*list)->next) {
+        if (*list == a) {
+            *list = a->next;
+            break;
+        }
+    }
+    a->next = NULL;
+}
+
+/**
+ * \brief           Frame clock callback, advances all running animations
+ * \note            Finished animations are moved to list of finished animations first
+ *                  and completion callbacks are called after walk, when callbacks may start or stop any animation
+ * \param[in]       t: Frame timer
+ */
+static void
+anim_frame(gui_timer_t* t) {
+    gui_anim_t *a, **prev, **last = &GUI.anims.finished;
+    uint32_t time = gui_sys_now(), elapsed;
+
+    for (prev = &GUI.anims.first; (a = *prev) != NULL; ) {
+        elapsed = time - a->start;
+        if (elapsed < a->duration) {
+            anim_setvalue(a, anim_getvalue(a, elapsed));
+            prev = &a->next;
+        } else {                                    /* Animation finished */
+            *prev = a->next;
+            a->next = NULL;
+            a->running = 2;                         /* Waiting for completion callback */
+            *last = a;
+            last = &a->next;
+        }
+    }
+    while ((a = GUI.anims.finished) != NULL) {      /* Callbacks may remove or restart waiting animations */
+        GUI.anims.finished = a->next;
+        a->next = NULL;
+        a->running = 0;
+        anim_setvalue(a, a->to);
+        if (a->done != NULL) {
+            a->done(a);                             /* Callback may start new animation */
+        }
+    }
+    if (GUI.anims.first == NULL) {                  /* Stop clock when nothing to animate */
+        guii_timer_stop(t);
+    }
+}
+
+/**
+ * \brief           Initialize animation structure
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       a: Animation structure
+ * \param[in]       h: Widget to invalidate on every value change or `NULL`
+ * \param[in]       done: Callback called when animation reaches end value or `NULL`
+ * \param[in]       params: Custom parameters for completion callback
+ */
+void
+guii_anim_init(gui_anim_t* const a, gui_handle_p h, void (*done)(gui_anim_t *), void* const params) {
+    memset(a, 0x00, sizeof(*a));
+    a->h = h;
+    a->done = done;
+    a->params = params;
+}
+
+/**
+ * \brief           Start animation of value from its current state to new value
+ *
+ *                  When animation is already running, it continues from current value to new end value.
+ *                  Animations advance on shared frame clock every \ref GUI_CFG_ANIM_FRAME_PERIOD milliseconds
+ *
+ * \note            When frame clock cannot be created, value is set to end value immediately
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       a: Animation structure, initialized with \ref guii_anim_init
+ * \param[in]       value: Pointer to value to animate
+ * \param[in]       to: End value
+ * \param[in]       duration: Duration in units of milliseconds
+ * \param[in]       ease: Easing curve
+ * \return          `1` if animation runs, `0` if value was set immediately
+ */
+uint8_t
+guii_anim_start(gui_anim_t* const a, int32_t* const value, int32_t to, uint16_t duration, gui_anim_ease_t ease) {
+    GUI_ASSERTPARAMS(a != NULL && value != NULL);
+
+    a->value = value;
+    a->from = *value;
+    a->to = to;
+    a->duration = duration;
+    a->ease = (uint8_t)ease;
+    a->start = gui_sys_now();
+
+    if (GUI.anims.frame == NULL && duration && *value != to) {  /* Frame clock is created on first use */
+        GUI.anims.frame = guii_timer_create(GUI_CFG_ANIM_FRAME_PERIOD, anim_frame, NULL);
+    }
+    if (!duration || *value == to || GUI.anims.frame == NULL) {
+        guii_anim_stop(a);
+        anim_setvalue(a, to);
+        if (a->done != NULL) {
+            a->done(a);
         }
+        return 0;
+    }
+    if (a->running == 2) {                          /* Restarted before completion callback was called */
+        anim_unlink(&GUI.anims.finished, a);
+        a->running = 0;
+    }
+    if (!a->running) {
+        if (GUI.anims.first == NULL) {              /* First animation starts frame clock */
+            guii_timer_startperiodic(GUI.anims.frame);
+        }
+        a->next = GUI.anims.first;
+        GUI.anims.first = a;
+        a->running = 1;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Stop animation at current value
+ * \note            Completion callback is not called
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       a: Animation structure
+ * \return          `1` if animation was running, `0` otherwise
+ */
+uint8_t
+guii_anim_stop(gui_anim_t* const a) {
+    GUI_ASSERTPARAMS(a != NULL);
+    if (a->running == 2) {                          /* Finished, completion callback is not called anymore */
+        anim_unlink(&GUI.anims.finished, a);
+        a->running = 0;
+        return 0;
+    } else if (!a->running) {
+        return 0;
+    }
+    anim_unlink(&GUI.anims.first, a);
+    a->running = 0;
+    if (GUI.anims.first == NULL && GUI.anims.frame != NULL) {
+        guii_timer_stop(GUI.anims.frame);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Stop all animations of widget
+ * \note            Called by library before widget memory is freed
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       h: Widget handle
+ */
+void
+guii_anim_stopwidget(gui_handle_p h) {
+    gui_anim_t *a, **prev;
+
+    for (prev = &GUI.anims.first; (a = *prev) != NULL; ) {
+        if (a->h == h) {
+            *prev = a->next;
+            a->running = 0;
+        } else {
+            prev = &a->next;
+        }
+    }
+    for (prev = &GUI.anims.finished; (a = *prev) != NULL; ) {
+        if (a->h == h) {                            /* Widget memory is freed, drop waiting callback */
+            *prev = a->next;
+            a->running = 0;
+        } else {
+            prev = &a->next;
+        }
+    }
+    if (GUI.anims.first == NULL && GUI.anims.frame != NULL) {
+        guii_timer_stop(GUI.anims.frame);
     }
-    return cnt;
 }
@@ -96,13 +96,23 @@ extern "C" {
  * \note            This function must take care of reseting memory to zero
  * \hideinitializer
  */
-#define GUI_MEMALLOC(size)         gui_mem_calloc(1, size)
+#define GUI_MEMALLOC(size)         GUI_MEMALLOC_TAG(size, GUI_MEM_TAG_OTHER)
+
+/**
+ * \brief           Allocate memory with specific size in bytes for subsystem
+ * \note            This function must take care of reseting memory to zero
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Allocation tag, member of \ref gui_mem_tag_t enumeration
+ * \hideinitializer
+ */
+#define GUI_MEMALLOC_TAG(size, tag) (GUI_MEM_CALLSITE(), gui_mem_calloc_tag(1, (size), (tag)))
 
 /**
  * \brief           Reallocate memory with specific size in bytes
+ * \note            Reallocated memory keeps its allocation tag
  * \hideinitializer
  */
-#define GUI_MEMREALLOC(ptr, size)  gui_mem_realloc(ptr, size)
+#define GUI_MEMREALLOC(ptr, size)  (GUI_MEM_CALLSITE(), gui_mem_realloc((ptr), (size)))
 
 /**
  * \brief           Free memory from specific address previously allocated with \ref GUI_MEMALLOC or \ref GUI_MEMREALLOC
@@ -113,6 +123,31 @@ extern "C" {
     (p) = NULL;                                     \
 } while (0)
 
+/**
+ * \brief           Allocate movable memory with specific size in bytes for subsystem
+ * \note            This function must take care of reseting memory to zero
+ * \param[in]       owner: Pointer to variable holding pointer to memory, updated when memory is moved
+ * \param[in]       size: Number of bytes to allocate
+ * \param[in]       tag: Allocation tag, member of \ref gui_mem_tag_t enumeration
+ * \hideinitializer
+ */
+#define GUI_MEMALLOC_MOVABLE(owner, size, tag)  (GUI_MEM_CALLSITE(), gui_mem_movable_alloc((void **)(owner), (size), (tag)))
+
+/**
+ * \brief           Reallocate movable memory with specific size in bytes
+ * \param[in]       owner: Pointer to variable holding pointer to memory, updated on success
+ * \param[in]       size: Number of bytes to allocate
+ * \hideinitializer
+ */
+#define GUI_MEMREALLOC_MOVABLE(owner, size)     (GUI_MEM_CALLSITE(), gui_mem_movable_realloc((void **)(owner), (size)))
+
+/**
+ * \brief           Free movable memory previously allocated with \ref GUI_MEMALLOC_MOVABLE or \ref GUI_MEMREALLOC_MOVABLE
+ * \param[in]       owner: Pointer to variable holding pointer to memory, set to `NULL`
+ * \hideinitializer
+ */
+#define GUI_MEMFREE_MOVABLE(owner)              gui_mem_movable_free((void **)(owner))
+
 /**
  * \brief           Get maximal value between 2 values
  * \param[in]       x: First value
@@ -192,6 +227,8 @@ extern "C" {
 
 guir_t      gui_init(void);
 int32_t     gui_process(void);
+uint32_t    gui_process_gettimeout(void);
+uint8_t     gui_process_wakeup(void);
 uint8_t     gui_seteventcallback(gui_eventcallback_t cb);
 
 #if GUI_CFG_OS || __DOXYGEN__
@@ -72,6 +72,8 @@
 
 /**
  * \brief           Maximal number of touch entries in buffer
+ *
+ * \note            Value is rounded up to power of `2`
  */
 #ifndef GUI_CFG_TOUCH_BUFFER_SIZE
 #define GUI_CFG_TOUCH_BUFFER_SIZE               10
@@ -86,13 +88,77 @@
 #define GUI_CFG_TOUCH_MAX_PRESSES               2
 #endif
 
+/**
+ * \brief           Enables (1) or disables (0) merging of queued touch move entries
+ *
+ *                  When enabled, consecutive pressed entries with the same number of touches
+ *                  are merged into latest one before processing, so only one touch move event
+ *                  is sent to widgets per processing loop. Press and release entries are never merged
+ */
+#ifndef GUI_CFG_TOUCH_COALESCE
+#define GUI_CFG_TOUCH_COALESCE                  1
+#endif
+
+/**
+ * \brief           Number of latest touch points kept in history for each touch
+ *
+ *                  History keeps all entries of current press, including the ones merged by
+ *                  \ref GUI_CFG_TOUCH_COALESCE, and is used to calculate touch velocity for gestures.
+ *                  Set to `0` to disable history, fling gesture is not detected in this case
+ */
+#ifndef GUI_CFG_TOUCH_HISTORY
+#define GUI_CFG_TOUCH_HISTORY                   8
+#endif
+
 /**
  * \brief           Maximal number of keyboard entries in buffer
+ *
+ * \note            Value is rounded up to power of `2`
  */
 #ifndef GUI_CFG_KEYBOARD_BUFFER_SIZE
 #define GUI_CFG_KEYBOARD_BUFFER_SIZE            10
 #endif 
 
+/**
+ * \brief           Enables (1) or disables (0) dropping oldest input entry when input buffer is full
+ *
+ *                  When disabled, new entry is dropped when buffer is full.
+ *                  When enabled, new entry overwrites oldest unprocessed entry,
+ *                  which is better choice for touch controllers where only latest position matters
+ */
+#ifndef GUI_CFG_INPUT_DROP_OLDEST
+#define GUI_CFG_INPUT_DROP_OLDEST               0
+#endif
+
+/**
+ * \brief           Memory barrier used by input buffers shared between interrupt and GUI thread
+ *
+ *                  It must prevent compiler and CPU to reorder memory accesses across it.
+ *                  Default is provided for GCC compatible, ARM, IAR and MSVC compilers.
+ *                  On MSVC for x86 and x64, compiler barrier is sufficient due to strong CPU memory ordering.
+ *                  Define it for any other compiler when touch or keyboard input is enabled,
+ *                  for example with `__DMB()` on Cortex-M with CMSIS
+ */
+#ifndef GUI_CFG_MEMORY_BARRIER
+#if defined(__GNUC__) || defined(__clang__)
+#define GUI_CFG_MEMORY_BARRIER()                __sync_synchronize()
+#elif defined(__CC_ARM)
+#define GUI_CFG_MEMORY_BARRIER()                do { __schedule_barrier(); __dmb(0xF); __schedule_barrier(); } while (0)
+#elif defined(__ICCARM__)
+#include <intrinsics.h>
+#define GUI_CFG_MEMORY_BARRIER()                __DMB()
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define GUI_CFG_MEMORY_BARRIER()                __dmb(0xF)
+#else
+#define GUI_CFG_MEMORY_BARRIER()                _ReadWriteBarrier()
+#endif
+#elif GUI_CFG_USE_TOUCH || GUI_CFG_USE_KEYBOARD
+#error "GUI_CFG_MEMORY_BARRIER must be defined in gui_config.h for this compiler"
+#endif
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) automatic invalidation of graph widgets
  *                    when graph dataset changes
@@ -117,6 +183,37 @@
 #define GUI_CFG_WIDGET_INSIDE_PARENT            0
 #endif
 
+/**
+ * \brief           Number of buckets in widget ID hash index
+ *
+ *                  Widgets are indexed by ID for fast search with \ref gui_widget_getbyid.
+ *                  Each bucket requires one pointer in memory
+ */
+#ifndef GUI_CFG_WIDGET_ID_HASH_SIZE
+#define GUI_CFG_WIDGET_ID_HASH_SIZE             32
+#endif
+
+/**
+ * \brief           Maximal number of bytes of single line drawn by text view widget in virtual mode
+ *
+ * \note            Line is copied to stack buffer of this size before drawing.
+ *                  Longer lines are truncated
+ */
+#ifndef GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN
+#define GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN        128
+#endif
+
+/**
+ * \brief           Free memory limit in units of bytes to release children of hidden deferred widgets
+ *
+ *                  When deferred widget with release option is hidden and less memory
+ *                  than this value is available, its children widgets are removed
+ *                  and created again on next show. Set to `0` to never release children
+ */
+#ifndef GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE
+#define GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE    2048
+#endif
+
 /**
  * \brief           Enables (1) or disables (0) automatic translations on widget text
  *
@@ -149,35 +246,119 @@
 #endif
 
 /**
- * \brief           Enables (1) or disables (0) alpha option for widgets
+ * \brief           Maximal number of memory regions assigned with \ref gui_mem_assignmemory
+ */
+#ifndef GUI_CFG_MEM_REGIONS
+#define GUI_CFG_MEM_REGIONS                     4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` two-level segregated fit (TLSF) allocator
  *
- *                  When enabled, widgets can overlay each other and bottom widget can be visible below top one
+ *                  TLSF allocates and frees memory in constant time, no matter how many blocks are in use.
+ *                  Default allocator keeps single list of free blocks and scans it on every call,
+ *                  which is slower when memory is split to many small blocks.
+ *
+ * \note            \ref GUI_CFG_MEM_ALIGNMENT must be at least `4` when enabled
  */
-#ifndef GUI_CFG_USE_ALPHA
-#define GUI_CFG_USE_ALPHA                      0
+#ifndef GUI_CFG_MEM_TLSF
+#define GUI_CFG_MEM_TLSF                        0
 #endif
 
 /**
- * \brief           Enables (1) or disables (0) widgets' position and size cache
+ * \brief           Number of bits for second level index of TLSF allocator
  *
- *                  All position/size values are relative to parent which means
- *                  that when drawing is in process, first step is to calculate
- *                  absolute coordinates on screen. This may take time as
- *                  there might be many parent widgets in tree and in case of many
- *                  widgets on same level, we can enter into huge loop calculations.
+ *                  Every power of 2 size range is split to `2^bits` lists of free blocks.
+ *                  More lists waste less memory on allocation, but need more memory for list heads.
  *
- *                  To prevent calculation each time and to save time,
- *                  cache is introduced. In this case, every widget change in position/size values
- *                  will immediately calculate absolute values and save into additional information fields.
+ * \note            Value must be between `1` and `5`. Used only when \ref GUI_CFG_MEM_TLSF is enabled
+ */
+#ifndef GUI_CFG_MEM_TLSF_SL_BITS
+#define GUI_CFG_MEM_TLSF_SL_BITS                3
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` memory usage counters for every allocation tag
  *
- * \note            When modifying widget position/size, all children widgets must be modified too
- *                  as absolute position/size may change on them aswell
+ *                  Every allocation stores its size and tag in small header before user memory.
+ *                  Counters are read with \ref gui_mem_gettagstat
+ */
+#ifndef GUI_CFG_MEM_STATS
+#define GUI_CFG_MEM_STATS                       0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` tracking of every allocated memory block
  *
- * \note            Enabling this feature significantly reduces calculation time,
- *                  but requires more memory for `4` dimension values (usually `8` bytes) per widget
+ *                  File, line and time of allocation are saved for every block
+ *                  and all allocated blocks can be printed with \ref gui_mem_dumpblocks to find leaks.
+ *
+ * \note            Used only when \ref GUI_CFG_MEM_STATS is enabled
  */
-#ifndef GUI_CFG_USE_POS_SIZE_CACHE
-#define GUI_CFG_USE_POS_SIZE_CACHE              0
+#ifndef GUI_CFG_MEM_DEBUG
+#define GUI_CFG_MEM_DEBUG                       0
+#endif
+
+/**
+ * \brief           Size of frame arena in units of bytes
+ *
+ *                  Frame arena is used for memory needed during single redraw only, such as alpha layers.
+ *                  Allocation only moves pointer in arena and arena is reset after every redraw,
+ *                  so main memory is not fragmented by short-lived blocks.
+ *
+ * \note            When arena is full or set to `0`, main memory is used and released at the end of redraw.
+ *                  Use \ref gui_mem_frame_getmaxused to find required size
+ */
+#ifndef GUI_CFG_MEM_FRAME_SIZE
+#define GUI_CFG_MEM_FRAME_SIZE                  0
+#endif
+
+/**
+ * \brief           Number of movable memory blocks checked for compaction in single \ref gui_process call
+ *
+ *                  Only memory referenced by single pointer in widget handle is movable,
+ *                  currently text line indexes of edittext and textview widgets and column array of listview widget.
+ *                  Widget text, list items and glyph cache entries stay on fixed addresses,
+ *                  compaction can only merge free memory around movable blocks.
+ *                  On every \ref gui_process call, up to this number of blocks are moved to lower addresses
+ *                  to merge free memory between them, so large allocations succeed on fragmented memory.
+ *                  Limit keeps time spent for compaction in single frame bounded, also under constant redraw load.
+ *
+ * \note            Every movable block uses additional memory for list and owner pointer.
+ *                  Set to `0` to disable compaction
+ */
+#ifndef GUI_CFG_MEM_COMPACT
+#define GUI_CFG_MEM_COMPACT                     0
+#endif
+
+/**
+ * \brief           Number of object size classes for widget memory pools
+ *
+ *                  Widgets of the same memory size are allocated from pool of this size,
+ *                  which grows in chunks from main memory. This prevents memory fragmentation
+ *                  when many widgets are created and removed.
+ *
+ * \note            When all classes are used, widgets of new sizes are allocated directly from memory.
+ *                  Set to `0` to disable pools
+ */
+#ifndef GUI_CFG_MEM_POOL_CLASSES
+#define GUI_CFG_MEM_POOL_CLASSES                16
+#endif
+
+/**
+ * \brief           Number of objects allocated at a time when memory pool needs to grow
+ */
+#ifndef GUI_CFG_MEM_POOL_CHUNK_OBJECTS
+#define GUI_CFG_MEM_POOL_CHUNK_OBJECTS          8
+#endif
+
+/**
+ * \brief           Enables (1) or disables (0) alpha option for widgets
+ *
+ *                  When enabled, widgets can overlay each other and bottom widget can be visible below top one
+ */
+#ifndef GUI_CFG_USE_ALPHA
+#define GUI_CFG_USE_ALPHA                      0
 #endif
 
 /**
@@ -224,6 +405,65 @@ gui_widget_setignoreinvalidate(h, 0, 1, 0);
 #define GUI_CFG_LONG_CLICK_TIMEOUT              1500
 #endif
 
+/**
+ * \brief           Maximal time between release and second press for double click in units of milliseconds
+ */
+#ifndef GUI_CFG_DBLCLICK_TIMEOUT
+#define GUI_CFG_DBLCLICK_TIMEOUT                300
+#endif
+
+/**
+ * \brief           Maximal distance between first and second press for double click in units of pixels
+ */
+#ifndef GUI_CFG_DBLCLICK_DISTANCE
+#define GUI_CFG_DBLCLICK_DISTANCE               30
+#endif
+
+/**
+ * \brief           Distance single touch must move before pan gesture starts in units of pixels
+ */
+#ifndef GUI_CFG_GESTURE_PAN_SLOP
+#define GUI_CFG_GESTURE_PAN_SLOP                10
+#endif
+
+/**
+ * \brief           Change of distance between `2` touches before pinch gesture starts in units of pixels
+ */
+#ifndef GUI_CFG_GESTURE_PINCH_SLOP
+#define GUI_CFG_GESTURE_PINCH_SLOP              10
+#endif
+
+/**
+ * \brief           Change of angle between `2` touches before rotate gesture starts in units of degrees
+ */
+#ifndef GUI_CFG_GESTURE_ROTATE_SLOP
+#define GUI_CFG_GESTURE_ROTATE_SLOP             10
+#endif
+
+/**
+ * \brief           Minimal release velocity for fling gesture in units of pixels per second
+ */
+#ifndef GUI_CFG_GESTURE_FLING_VELOCITY
+#define GUI_CFG_GESTURE_FLING_VELOCITY          300
+#endif
+
+/**
+ * \brief           Time window of latest touch points used for velocity calculation in units of milliseconds
+ */
+#ifndef GUI_CFG_GESTURE_VELOCITY_WINDOW
+#define GUI_CFG_GESTURE_VELOCITY_WINDOW         100
+#endif
+
+/**
+ * \brief           Animation frame period in units of milliseconds
+ *
+ *                  All running animations advance together once per period,
+ *                  so any number of animations causes single redraw per frame
+ */
+#ifndef GUI_CFG_ANIM_FRAME_PERIOD
+#define GUI_CFG_ANIM_FRAME_PERIOD               20
+#endif
+
 #ifndef GUI_CFG_SYS_PORT
 #define GUI_CFG_SYS_PORT                        GUI_SYS_PORT_CMSIS_OS
 #endif
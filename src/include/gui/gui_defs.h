@@ -83,6 +83,13 @@ extern "C" {
 #define GUI_FLAG_IGNORE_INVALIDATE          ((uint32_t)0x00004000)  /*!< Indicates widget invalidation is ignored completely when invalidating it directly */
 #define GUI_FLAG_FIRST_INVALIDATE           ((uint32_t)0x00008000)  /*!< Indicates widget is invalidated for "first" time, thus ignore check if parent is hidden or not */
 #define GUI_FLAG_TOUCH_MOVE                 ((uint32_t)0x00010000)  /*!< Indicates widget callback has processed touch move event. This parameter works in conjunction with \ref GUI_FLAG_ACTIVE flag */
+#define GUI_FLAG_TEXT_RELAYOUT              ((uint32_t)0x00020000)  /*!< Indicates widget text has been replaced and any text layout cached by widget must be rebuilt */
+#define GUI_FLAG_GEOMETRY_DIRTY             ((uint32_t)0x00200000)  /*!< Indicates cached absolute position and size of widget are not valid and must be recalculated before use */
+#define GUI_FLAG_INVALIDATE_PENDING         ((uint32_t)0x00400000)  /*!< Indicates widget was invalidated inside update transaction and must be processed at the end of it */
+#define GUI_FLAG_DEFERRED                   ((uint32_t)0x00800000)  /*!< Indicates children widgets are not created yet or were released and must be created on first show */
+#define GUI_FLAG_DEFERRED_RELEASE           ((uint32_t)0x01000000)  /*!< Indicates children widgets of deferred widget may be released when widget is hidden */
+#define GUI_FLAG_LAYOUT_DIRTY               ((uint32_t)0x02000000)  /*!< Indicates children widgets must be arranged again by widget layout */
+#define GUI_FLAG_INVALIDATE_CLIPPING        ((uint32_t)0x04000000)  /*!< Indicates widget area must be added to clipping region at the end of update transaction */
 
 /**
  * \}
@@ -203,10 +210,21 @@ typedef struct gui_linkedlistroot {
  * \brief           Core timer structure for GUI timers
  */
 typedef struct gui_timer_core {
-    uint32_t time;                          /*!< Last processed time */
-    gui_linkedlistroot_t list;              /*!< Root linked list object */
+    struct gui_timer** queue;               /*!< Active timers, ordered as binary min-heap by deadline */
+    size_t count;                           /*!< Number of active timers in queue */
+    size_t size;                            /*!< Number of allocated entries in queue */
+    size_t timers;                          /*!< Number of created timers */
 } gui_timer_core_t;
 
+/**
+ * \brief           Core animation structure, all animations advance together on single frame clock
+ */
+typedef struct gui_anim_core {
+    struct gui_anim* first;                 /*!< First running animation */
+    struct gui_anim* finished;              /*!< First finished animation waiting for completion callback */
+    struct gui_timer* frame;                /*!< Frame clock timer, running while any animation runs */
+} gui_anim_core_t;
+
 typedef uint32_t    gui_id_t;               /*!< GUI object ID */
 typedef uint32_t    gui_color_t;            /*!< Color definition */
 typedef int16_t     gui_dim_t;              /*!< GUI dimensions in units of pixels */
@@ -255,6 +273,29 @@ typedef uint8_t     gui_char;               /*!< GUI char data type for all stri
  * \}
  */
 
+/**
+ * \brief           Scale of widget position and size values in units of percent.
+ *                  Value of `1%` is stored as `GUI_PERCENT_SCALE` in widget geometry
+ */
+#define GUI_PERCENT_SCALE                   ((int32_t)64)
+
+/**
+ * \brief           Maximal absolute value in units of percent which fits into widget geometry.
+ *                  Values set in units of percent are clamped to this range
+ */
+#define GUI_PERCENT_MAX                     ((int32_t)(GUI_DIM_MAX / GUI_PERCENT_SCALE))
+
+/**
+ * \brief           Get number of pixels from widget geometry value in units of percent, using integer math only
+ * \note            Result is rounded half away from zero, negative and positive values round symmetrically
+ * \param[in]       val: Value in units of `1 / GUI_PERCENT_SCALE` percent
+ * \param[in]       total: Number of pixels for `100%`
+ * \hideinitializer
+ */
+#define GUI_DIM_PERCENT(val, total)         GUI_DIM((val) < 0 ? \
+                                                -((-(int32_t)(val) * (int32_t)(total) + 50 * GUI_PERCENT_SCALE) / (100 * GUI_PERCENT_SCALE)) : \
+                                                ((int32_t)(val) * (int32_t)(total) + 50 * GUI_PERCENT_SCALE) / (100 * GUI_PERCENT_SCALE))
+
 /**
  * \brief           Basic widget structure
  */
@@ -306,6 +347,49 @@ typedef struct {
     uint32_t time;                          /*!< Time when touch was recorded */
 } gui_touch_data_t;
 
+/**
+ * \brief           Touch history point of first touch
+ */
+typedef struct {
+    gui_dim_t x;                            /*!< Touch X coordinate */
+    gui_dim_t y;                            /*!< Touch Y coordinate */
+    uint32_t time;                          /*!< Time when touch was recorded */
+} gui_touch_point_t;
+
+/**
+ * \brief           State of continuous gesture
+ */
+typedef enum {
+    GUI_GESTURE_STATE_BEGIN = 0x00,         /*!< Gesture has been just recognized */
+    GUI_GESTURE_STATE_UPDATE,               /*!< Gesture continues */
+    GUI_GESTURE_STATE_END,                  /*!< Gesture has finished */
+} gui_gesture_state_t;
+
+/**
+ * \brief           Gesture data for gesture events
+ */
+typedef struct {
+    gui_gesture_state_t state;              /*!< State of pan, pinch or rotate gesture */
+    gui_dim_t x;                            /*!< `X` position relative to widget, first touch or center between `2` touches */
+    gui_dim_t y;                            /*!< `Y` position relative to widget, first touch or center between `2` touches */
+    gui_dim_t dx;                           /*!< `X` movement since previous pan event */
+    gui_dim_t dy;                           /*!< `Y` movement since previous pan event */
+    gui_dim_t total_x;                      /*!< `X` movement since touch press */
+    gui_dim_t total_y;                      /*!< `Y` movement since touch press */
+    float vx;                               /*!< `X` velocity in units of pixels per second, valid on pan end and fling */
+    float vy;                               /*!< `Y` velocity in units of pixels per second, valid on pan end and fling */
+    float scale;                            /*!< Distance between touches versus previous pinch event */
+    float rotation;                         /*!< Angle change between touches since previous rotate event in units of degrees */
+
+    uint8_t flags;                          /*!< Active gestures, used by gesture engine */
+    gui_dim_t abs_x;                        /*!< Absolute `X` position, used by gesture engine */
+    gui_dim_t abs_y;                        /*!< Absolute `Y` position, used by gesture engine */
+    gui_dim_t start_x;                      /*!< Absolute `X` position on gesture start, used by gesture engine */
+    gui_dim_t start_y;                      /*!< Absolute `Y` position on gesture start, used by gesture engine */
+    float distance;                         /*!< Distance between touches on last pinch event, used by gesture engine */
+    float angle;                            /*!< Angle between touches on last rotate event, used by gesture engine */
+} gui_gesture_t;
+
 /**
  * \brief           Internal touch structure used for widget callbacks
  */
@@ -323,10 +407,7 @@ typedef struct {
     gui_dim_t widget_y;                     /*!< Widget absolute `Y` position */
     gui_dim_t widget_width;                 /*!< Widget width */
     gui_dim_t widget_height;                /*!< Widget height */
-#if GUI_CFG_TOUCH_MAX_PRESSES > 1 || __DOXYGEN__
-    float distance_old;                     /*!< Old distance between `2` points */
-    float distance;                         /*!< Distance between `2` points when `2` touch elements are detected */
-#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 || __DOXYGEN__ */
+    gui_gesture_t gesture;                  /*!< Gesture data, valid on gesture events */
     struct pt pt;                           /*!< Protothread structure */
 } guii_touch_data_t;
 
@@ -768,9 +849,9 @@ typedef struct {
  * \brief           Timer structure
  */
 typedef struct gui_timer {
-    gui_linkedlist_t list;                  /*!< Linked list entry, must be first on the list */
+    uint32_t deadline;                      /*!< Absolute time of next expiration in units of milliseconds */
+    size_t index;                           /*!< Position in queue of active timers, valid only when timer is active */
     uint16_t period;                        /*!< Timer period value */
-    uint16_t counter;                       /*!< Timer current counter */
     uint8_t flags;                          /*!< Timer flags */
     void* params;                           /*!< Custom parameters passed to callback function */
     void (*callback)(struct gui_timer *);   /*!< Timer callback function */
@@ -782,6 +863,37 @@ typedef struct gui_timer {
  */
 typedef gui_timer_t* gui_timer_p;
 
+/**
+ * \ingroup         GUI_ANIM
+ * \brief           Easing curves of animation
+ */
+typedef enum {
+    GUI_ANIM_EASE_LINEAR = 0x00,            /*!< Constant speed */
+    GUI_ANIM_EASE_IN,                       /*!< Start slow and accelerate */
+    GUI_ANIM_EASE_OUT,                      /*!< Start fast and decelerate */
+    GUI_ANIM_EASE_IN_OUT,                   /*!< Accelerate in first half and decelerate in second half */
+} gui_anim_ease_t;
+
+/**
+ * \ingroup         GUI_ANIM
+ * \brief           Animation of single integer property
+ * \note            Structure is usually part of widget object and must stay valid while animation runs
+ */
+typedef struct gui_anim {
+    struct gui_anim* next;                  /*!< Next animation in running or finished list */
+    gui_handle_p h;                         /*!< Widget to invalidate when value changes or `NULL` */
+    int32_t* value;                         /*!< Pointer to animated value */
+    int32_t from;                           /*!< Value at animation start */
+    int32_t to;                             /*!< Value at animation end */
+    uint32_t start;                         /*!< Start time in units of milliseconds */
+    uint16_t duration;                      /*!< Duration in units of milliseconds */
+    uint8_t ease;                           /*!< Easing curve, member of \ref gui_anim_ease_t */
+    uint8_t running;                        /*!< Set to `1` while in list of running animations,
+                                                    `2` while in list of finished animations waiting for completion callback */
+    void (*done)(struct gui_anim *);        /*!< Callback called when animation reaches end value or `NULL` */
+    void* params;                           /*!< Custom parameters for completion callback */
+} gui_anim_t;
+
 /**
  * \addtogroup      GUI_WIDGETS_CORE
  * \{
@@ -1042,13 +1154,82 @@ typedef enum {
      * \param[out]  result: None
      */
     GUI_EVT_ONDISMISS,
+    
+    /**
+     * \brief       Deferred widget is shown and has no children description, children widgets must be created now
+     *
+     * \note        Widget is sent with its ignore invalidate flag set.
+     *              It is invalidated together with all children once event returns
+     *
+     * \param[in]   param: None
+     * \param[out]  result: None
+     * \sa          gui_widget_setdeferred
+     */
+    GUI_EVT_BUILDCHILDREN,
+
+    /**
+     * \brief       Single touch moved more than \ref GUI_CFG_GESTURE_PAN_SLOP, sent on every move and on release
+     *
+     * \note        Gesture events are sent to active widget first and then to its parents until callback returns `1`
+     *
+     * \param[in]   param: Pointer to \ref guii_touch_data_t structure with valid `gesture` member
+     * \param[out]  result: None
+     * \sa          GUI_EVT_FLING
+     */
+    GUI_EVT_PAN,
+
+    /**
+     * \brief       Pan gesture ended with velocity of at least \ref GUI_CFG_GESTURE_FLING_VELOCITY
+     *
+     * \param[in]   param: Pointer to \ref guii_touch_data_t structure with valid `gesture` member
+     * \param[out]  result: None
+     */
+    GUI_EVT_FLING,
+
+    /**
+     * \brief       Distance between `2` touches changed more than \ref GUI_CFG_GESTURE_PINCH_SLOP
+     *
+     * \param[in]   param: Pointer to \ref guii_touch_data_t structure with valid `gesture` member
+     * \param[out]  result: None
+     */
+    GUI_EVT_PINCH,
+
+    /**
+     * \brief       Angle between `2` touches changed more than \ref GUI_CFG_GESTURE_ROTATE_SLOP
+     *
+     * \param[in]   param: Pointer to \ref guii_touch_data_t structure with valid `gesture` member
+     * \param[out]  result: None
+     */
+    GUI_EVT_ROTATE,
 } gui_widget_evt_t;
 
 /**
- * \brief           Style information
+ * \defgroup        GUI_STYLE_FLAGS Style flags
+ * \brief           List of flags for \ref gui_style_t structure
+ * \{
  */
-typedef struct {
-    void* arg;
+#define GUI_STYLE_FLAG_PADDING              ((uint8_t)0x01) /*!< Style sets padding of widget */
+#define GUI_STYLE_FLAG_3D_SET               ((uint8_t)0x02) /*!< Style sets 3D mode of widget */
+#define GUI_STYLE_FLAG_3D                   ((uint8_t)0x04) /*!< 3D mode is enabled when \ref GUI_STYLE_FLAG_3D_SET is set */
+#define GUI_STYLE_FLAG_COLORS_ALLOC         ((uint8_t)0x08) /*!< Colors are allocated together with style and can be modified */
+/**
+ * \}
+ */
+
+/**
+ * \brief           Shared widget style
+ *
+ *                  Style is reference counted and used by any number of widgets.
+ *                  When single widget modifies its style, it gets its own copy first
+ */
+typedef struct gui_style {
+    size_t ref;                             /*!< Number of references to style */
+    size_t users;                           /*!< Number of widgets using style, to skip or stop scan of widgets on style change */
+    const gui_color_t* colors;              /*!< Colors in the same order as widget colors enumeration or `NULL` for widget defaults */
+    uint8_t color_count;                    /*!< Number of colors in array */
+    const gui_font_t* font;                 /*!< Font for widgets or `NULL` to keep widget font */
+    uint32_t padding;                       /*!< Padding in the same format as widget padding, used with \ref GUI_STYLE_FLAG_PADDING */
+    uint8_t flags;                          /*!< Style flags, \ref GUI_STYLE_FLAGS */
 } gui_style_t;
 
 /**
@@ -1127,6 +1308,26 @@ typedef struct {
     uint8_t color_count;                    /*!< Number of colors used in widget */
 } gui_widget_t;
 
+/**
+ * \brief           List of layout types for children widgets
+ */
+typedef enum {
+    GUI_LAYOUT_ROW = 0x00,                  /*!< Children are placed left to right, width is shared by weights, height is full inner height */
+    GUI_LAYOUT_COLUMN,                      /*!< Children are placed top to bottom, height is shared by weights, width is full inner width */
+    GUI_LAYOUT_WRAP,                        /*!< Children keep their size and are placed left to right, wrapped to new row at right edge */
+    GUI_LAYOUT_GRID,                        /*!< Children are placed in columns of equal width, weight is number of columns for child */
+} gui_layout_type_t;
+
+/**
+ * \brief           Layout for children widgets
+ * \note            Structure is not copied and must stay valid while layout is set to widget
+ */
+typedef struct {
+    gui_layout_type_t type;                 /*!< Layout type */
+    uint8_t columns;                        /*!< Number of columns for \ref GUI_LAYOUT_GRID layout */
+    gui_dim_t spacing;                      /*!< Space between children in units of pixels */
+} gui_layout_t;
+
 #if defined(GUI_INTERNAL) || __DOXYGEN__
 
 /**
@@ -1141,14 +1342,15 @@ typedef struct gui_handle {
     const gui_widget_t* widget;             /*!< Widget parameters with callback functions */
     gui_widget_evt_fn callback;             /*!< Callback function prototype */
     struct gui_handle* parent;              /*!< Pointer to parent widget */
+    struct gui_handle* id_next;             /*!< Next widget with the same hash in widget ID index */
 
-    float x;                                /*!< Object X position relative to parent window in units of pixel/percent */
-    float y;                                /*!< Object Y position relative to parent window in units of pixel/percent */
-    float width;                            /*!< Object width in units of pixel/percent */
-    float height;                           /*!< Object height in units of pixel/percent */
+    /* Position and size in units of pixels or in units of `1 / GUI_PERCENT_SCALE` percent, depending on widget flags */
+    gui_dim_t x;                            /*!< Object X position relative to parent window */
+    gui_dim_t y;                            /*!< Object Y position relative to parent window */
+    gui_dim_t width;                        /*!< Object width */
+    gui_dim_t height;                       /*!< Object height */
 
-#if GUI_CFG_USE_POS_SIZE_CACHE || __DOXYGEN__
-    /* Absolute values for position and size, changed each time position/size is modified */
+    /* Absolute values for position and size, recalculated on first use after position/size is modified */
     gui_dim_t abs_x;                        /*!< Absolute X position of top-left corner on screen */
     gui_dim_t abs_y;                        /*!< Absolute Y position of top-left corner on screen */
     gui_dim_t abs_width;                    /*!< Absolute width on screen in units of pixels */
@@ -1159,7 +1361,6 @@ typedef struct gui_handle {
     gui_dim_t abs_visible_y1;               /*!< Absolute visible top Y positon on screen for widget */
     gui_dim_t abs_visible_x2;               /*!< Absolute visible right X position on screen for widget */
     gui_dim_t abs_visible_y2;               /*!< Absolute visible bottom Y positon on screen for widget */
-#endif /* GUI_CFG_USE_POS_SIZE_CACHE */
 
     uint32_t padding;                       /*!< 4-bytes long padding, each byte of one side, MSB = top padding, LSB = left padding.
                                                     Used for children widgets if virtual padding should be used */
@@ -1173,13 +1374,23 @@ typedef struct gui_handle {
     gui_char* text;                         /*!< Pointer to widget text if exists */
     size_t textmemsize;                     /*!< Number of bytes for text when dynamically allocated */
     size_t textcursor;                      /*!< Text cursor position */
+    size_t textgaplen;                      /*!< Number of bytes of gap in text memory at cursor position when text is edited.
+                                                    When not `0`, text after gap ends at the end of text memory */
     gui_timer_t* timer;                     /*!< Software timer pointer */
-    gui_color_t* colors;                    /*!< Pointer to allocated color memory when custom colors are used */
+    gui_style_p style;                      /*!< Pointer to style when custom style or colors are used */
     
     /* Scroll feature, available only for widgets with children support */
     gui_dim_t x_scroll;                     /*!< Scroll of widgets in horizontal direction in units of pixels */
     gui_dim_t y_scroll;                     /*!< Scroll of widgets in vertical direction in units of pixels */
     
+    /* Layout feature, available only for widgets with children support */
+    const gui_layout_t* layout;             /*!< Layout for children widgets or `NULL` when children are placed manually */
+    gui_dim_t layout_width;                 /*!< Width of all children in units of pixels, calculated by layout */
+    gui_dim_t layout_height;                /*!< Height of all children in units of pixels, calculated by layout */
+    uint8_t layout_weight;                  /*!< Weight of widget in parent layout */
+    
+    const struct gui_widget_tree* tree;     /*!< Tree node with children description of deferred widget */
+    
     void* arg;                              /*!< Pointer to optional user data */
 } gui_handle;
 #endif /* defined(GUI_INTERNAL) || __DOXYGEN__ */
@@ -1189,6 +1400,30 @@ typedef struct gui_handle {
  */
 typedef gui_handle_p (*gui_widget_createfunc_fn)(gui_id_t, float, float, float, float, gui_handle_p, gui_widget_evt_fn, uint16_t);
 
+/**
+ * \brief           Constant widget tree node, used with \ref gui_widget_create_tree
+ *
+ *                  Nodes do not hold any runtime data and can be placed in read-only memory
+ */
+typedef struct gui_widget_tree {
+    gui_widget_createfunc_fn create;        /*!< Widget create function, such as \ref gui_button_create */
+    gui_id_t id;                            /*!< Widget ID */
+    float x;                                /*!< X position in units of pixels or percent */
+    float y;                                /*!< Y position in units of pixels or percent */
+    float width;                            /*!< Width in units of pixels or percent */
+    float height;                           /*!< Height in units of pixels or percent */
+    uint16_t flags;                         /*!< Widget create flags, \ref GUI_WIDGET_CREATE_FLAGS */
+    uint8_t tree_flags;                     /*!< Tree node flags, \ref GUI_WIDGET_TREE_FLAGS */
+    int32_t zindex;                         /*!< Widget z-index */
+    gui_widget_evt_fn callback;             /*!< Widget event callback or `NULL` */
+    const gui_char* text;                   /*!< Widget text or `NULL` */
+    const gui_color_t* colors;              /*!< Custom colors from index `0` or `NULL` to use widget defaults. Array is shared by widgets and must stay valid */
+    uint8_t colors_count;                   /*!< Number of entries in `colors` array */
+    void* arg;                              /*!< User data for widget */
+    const struct gui_widget_tree* children; /*!< Array of child nodes or `NULL` */
+    size_t children_count;                  /*!< Number of entries in `children` array */
+} gui_widget_tree_t;
+
 /**
  * \}
  */
@@ -47,13 +47,17 @@ extern "C" {
 #include "gui/gui.h"
     
 uint8_t gui_input_touchadd(gui_touch_data_t* const ts);
+uint32_t gui_input_touchgetoverflow(void);
 uint8_t gui_input_keyadd(gui_keyboard_data_t* const kb);
+uint32_t gui_input_keygetoverflow(void);
 
 #if !__DOXYGEN__ && defined(GUI_INTERNAL)
 void guii_input_init(void);
 uint8_t guii_input_touchavailable(void);
 uint8_t guii_input_touchread(gui_touch_data_t* const ts);
+size_t guii_input_touchgethistory(uint8_t touch, gui_touch_point_t* const points, size_t count);
 uint8_t guii_input_keyread(gui_keyboard_data_t* const kb);
+uint8_t guii_input_keyavailable(void);
 #endif /* !__DOXYGEN__ && defined(GUI_INTERNAL) */
 
 /**
@@ -54,6 +54,7 @@ uint8_t gui_math_sqrt(float x, float* const result);
 uint8_t gui_math_rsqrt(float x, float* const result);
 uint8_t gui_math_distancebetweenxy(float x1, float y1, float x2, float y2, float* const result);
 uint8_t gui_math_centerofxy(float x1, float y1, float x2, float y2, float* const resultx, float* const resulty);
+uint8_t gui_math_anglebetweenxy(float x1, float y1, float x2, float y2, float* const result);
     
 /**
  * \}
@@ -48,12 +48,24 @@ extern "C" {
  * \{
  */
 
+/**
+ * \brief           Allocation classes, used to place memory to region of matching type
+ */
+typedef enum {
+    GUI_MEM_CLASS_DEFAULT = 0x00,       /*!< General purpose memory */
+    GUI_MEM_CLASS_FAST,                 /*!< Small and frequently used objects, such as widgets and timers. Use for internal SRAM */
+    GUI_MEM_CLASS_BULK,                 /*!< Large pixel data, such as layers and glyphs. Use for external SDRAM */
+    GUI_MEM_CLASS_END,                  /*!< Number of classes, not valid class */
+} gui_mem_class_t;
+
 /**
  * \brief           Single memory region descriptor
  */
 typedef struct mem_region_t {
     void* start_address;                /*!< Start address of region */
     size_t size;                        /*!< Size in units of bytes of region */
+    gui_mem_class_t mem_class;          /*!< Class of allocations region is intended for.
+                                            Other allocations use region only when memory of their class is full */
 } mem_region_t;
 
 /**
@@ -61,13 +73,79 @@ typedef struct mem_region_t {
  */
 typedef mem_region_t gui_mem_region_t;
 
+/**
+ * \brief           Memory pool statistics
+ */
+typedef struct {
+    size_t size;                        /*!< Size of single object in pool in units of bytes */
+    size_t used;                        /*!< Number of currently allocated objects */
+    size_t max_used;                    /*!< Maximal number of allocated objects at a time */
+    size_t total;                       /*!< Number of objects in all chunks of pool, used and free */
+    size_t chunks;                      /*!< Number of chunks allocated from memory */
+} gui_mem_pool_stat_t;
+
+/**
+ * \brief           Allocation tags, used to count memory usage per subsystem
+ */
+typedef enum {
+    GUI_MEM_TAG_OTHER = 0x00,           /*!< Allocation without specific subsystem */
+    GUI_MEM_TAG_WIDGET,                 /*!< Widget handles, pools and styles */
+    GUI_MEM_TAG_GLYPH,                  /*!< Cached font characters */
+    GUI_MEM_TAG_TEXT,                   /*!< Widget text memory and text layout */
+    GUI_MEM_TAG_TIMER,                  /*!< Software timers */
+    GUI_MEM_TAG_LAYER,                  /*!< Drawing layers */
+    GUI_MEM_TAG_ITEM,                   /*!< Items of list widgets */
+    GUI_MEM_TAG_END,                    /*!< Number of tags, not valid tag */
+} gui_mem_tag_t;
+
+/**
+ * \brief           Memory usage statistics of allocation tag
+ */
+typedef struct {
+    size_t used;                        /*!< Number of currently allocated bytes */
+    size_t max_used;                    /*!< Maximal number of allocated bytes at a time */
+    size_t blocks;                      /*!< Number of currently allocated blocks */
+    size_t failed;                      /*!< Number of failed allocations */
+} gui_mem_tag_stat_t;
+
+/**
+ * \brief           Set file and line of next allocation when \ref GUI_CFG_MEM_DEBUG is enabled
+ * \hideinitializer
+ */
+#if GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG
+#define GUI_MEM_CALLSITE()              gui_mem_setcallsite(__FILE__, __LINE__)
+#else
+#define GUI_MEM_CALLSITE()              ((void)0)
+#endif /* GUI_CFG_MEM_STATS && GUI_CFG_MEM_DEBUG */
+
 void* gui_mem_alloc(uint32_t size);
 void* gui_mem_realloc(void* ptr, size_t size);
 void* gui_mem_calloc(size_t num, size_t size);
+void* gui_mem_calloc_tag(size_t num, size_t size, gui_mem_tag_t tag);
 void gui_mem_free(void* ptr);
 size_t gui_mem_getfree(void);
 size_t gui_mem_getfull(void);
 size_t gui_mem_getminfree(void);
+size_t gui_mem_getlargestfree(void);
+size_t gui_mem_getfreehistogram(size_t* hist, size_t len);
+uint8_t gui_mem_gettagstat(gui_mem_tag_t tag, gui_mem_tag_stat_t* stat);
+uint8_t gui_mem_settagclass(gui_mem_tag_t tag, gui_mem_class_t mem_class);
+void gui_mem_setcallsite(const char* file, uint32_t line);
+size_t gui_mem_dumpblocks(uint32_t min_age);
+
+void* gui_mem_pool_alloc(size_t size);
+void gui_mem_pool_free(void* ptr, size_t size);
+uint8_t gui_mem_pool_getstat(size_t index, gui_mem_pool_stat_t* stat);
+
+void* gui_mem_movable_alloc(void** owner, size_t size, gui_mem_tag_t tag);
+void* gui_mem_movable_realloc(void** owner, size_t size);
+void gui_mem_movable_free(void** owner);
+size_t gui_mem_compact(size_t max_blocks);
+
+void* gui_mem_frame_alloc(size_t size);
+void gui_mem_frame_free(void* ptr);
+void gui_mem_frame_reset(void);
+size_t gui_mem_frame_getmaxused(void);
 
 uint8_t gui_mem_assignmemory(const gui_mem_region_t* regions, size_t size);
     
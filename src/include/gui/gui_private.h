@@ -91,7 +91,11 @@ typedef struct {
     gui_handle_p focused_widget_prev;       /*!< Pointer to previously focused widget */
     
     gui_linkedlistroot_t root;              /*!< Root linked list of widgets */
+    gui_handle_p widget_ids[GUI_CFG_WIDGET_ID_HASH_SIZE];   /*!< Hash index of widgets by ID, widgets with the same hash are linked in creation order */
+    uint16_t update_level;                  /*!< Nesting level of widget update transactions, invalidation is deferred when not `0` */
+    size_t update_pending;                  /*!< Number of widgets with invalidation deferred to the end of update transaction */
     gui_timer_core_t timers;                /*!< Software structure management */
+    gui_anim_core_t anims;                  /*!< Running animations */
     
     gui_linkedlistroot_t root_fonts;        /*!< Root linked list of font widgets */
     
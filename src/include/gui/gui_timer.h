@@ -57,6 +57,11 @@ extern "C" {
  */
 #define guii_timer_getparams(t)        ((t)->params)
 
+/**
+ * \brief           Value returned by \ref guii_timer_gettimeout when there is no active timer
+ */
+#define GUI_TIMER_NO_DEADLINE           ((uint32_t)0xFFFFFFFFUL)
+
 gui_timer_t* guii_timer_create(uint16_t period, void (*callback)(gui_timer_t *), void* const param);
 uint8_t guii_timer_remove(gui_timer_t** const t);
 uint8_t guii_timer_start(gui_timer_t* const t);
@@ -65,8 +70,33 @@ uint8_t guii_timer_stop(gui_timer_t* const t);
 uint8_t guii_timer_reset(gui_timer_t* const t);
 
 uint32_t guii_timer_getactivecount(void);
+uint32_t guii_timer_gettimeout(void);
 void guii_timer_process(void);
 
+/**
+ * \}
+ */
+
+/**
+ * \ingroup         GUI_UTILS
+ * \defgroup        GUI_ANIM Animations
+ * \brief           Property animations with easing, driven by shared frame clock
+ * \{
+ */
+
+/**
+ * \brief           Check if animation is running
+ * \param[in]       a: Animation structure
+ * \return          `1` if running, `0` otherwise
+ * \hideinitializer
+ */
+#define guii_anim_isrunning(a)          ((a)->running == 1)
+
+void guii_anim_init(gui_anim_t* const a, gui_handle_p h, void (*done)(gui_anim_t *), void* const params);
+uint8_t guii_anim_start(gui_anim_t* const a, int32_t* const value, int32_t to, uint16_t duration, gui_anim_ease_t ease);
+uint8_t guii_anim_stop(gui_anim_t* const a);
+void guii_anim_stopwidget(gui_handle_p h);
+
 /**
  * \}
  */
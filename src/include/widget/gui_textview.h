@@ -74,10 +74,26 @@ typedef enum {
     GUI_TEXTVIEW_HALIGN_RIGHT = GUI_HALIGN_RIGHT    /*!< Horizontal align right */
 } gui_textalign_halign_t;
 
+/**
+ * \brief           Read callback for text view data in virtual mode
+ * \param[in]       h: Widget handle
+ * \param[in]       offset: Byte offset in data to start reading from
+ * \param[out]      buff: Output buffer to copy data to
+ * \param[in]       len: Number of bytes to read
+ * \return          Number of bytes actually read
+ */
+typedef size_t (*gui_textview_read_fn)(gui_handle_p h, size_t offset, gui_char* buff, size_t len);
+
 gui_handle_p    gui_textview_create(gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_evt_fn evt_fn, uint16_t flags);
 uint8_t         gui_textview_setcolor(gui_handle_p h, gui_textview_color_t index, gui_color_t color);
 uint8_t         gui_textview_setvalign(gui_handle_p h, gui_textalign_valign_t align);
 uint8_t         gui_textview_sethalign(gui_handle_p h, gui_textalign_halign_t align);
+uint8_t         gui_textview_setvirtual(gui_handle_p h, uint8_t en);
+uint8_t         gui_textview_setreadcallback(gui_handle_p h, gui_textview_read_fn read_fn, size_t len);
+uint8_t         gui_textview_setdatalength(gui_handle_p h, size_t len);
+uint8_t         gui_textview_settopline(gui_handle_p h, size_t line);
+size_t          gui_textview_gettopline(gui_handle_p h);
+size_t          gui_textview_getlinecount(gui_handle_p h);
     
 /**
  * \}
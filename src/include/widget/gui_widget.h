@@ -83,6 +83,26 @@ extern "C" {
 #define GUI_FLAG_WIDGET_CREATE_NO_PARENT            0x02    /*!< No parent widget */
 #define GUI_FLAG_WIDGET_CREATE_IGNORE_INVALIDATE    0x04    /*!< Ignore invalidate on widget creation */
 
+/**
+ * \}
+ */
+
+/**
+ * \defgroup        GUI_WIDGET_TREE_FLAGS Widget tree node flags
+ * \brief           A list of flags supported for widget tree nodes
+ *
+ * List of flags used in \ref gui_widget_tree_t node, separate from widget create flags
+ * 
+ * \{
+ */
+#define GUI_FLAG_WIDGET_TREE_XPOS_PERCENT           0x01    /*!< Tree node X position is in units of percent */
+#define GUI_FLAG_WIDGET_TREE_YPOS_PERCENT           0x02    /*!< Tree node Y position is in units of percent */
+#define GUI_FLAG_WIDGET_TREE_WIDTH_PERCENT          0x04    /*!< Tree node width is in units of percent */
+#define GUI_FLAG_WIDGET_TREE_HEIGHT_PERCENT         0x08    /*!< Tree node height is in units of percent */
+#define GUI_FLAG_WIDGET_TREE_HIDDEN                 0x10    /*!< Tree node widget is created hidden */
+#define GUI_FLAG_WIDGET_TREE_DEFERRED               0x20    /*!< Children of hidden tree node are created on first widget show */
+#define GUI_FLAG_WIDGET_TREE_RELEASE                0x40    /*!< Children of deferred tree node are released on hide when memory is low */
+
 /**
  * \}
  */
@@ -120,7 +140,7 @@ extern "C" {
  * \hideinitializer
  */
 #define guii_widget_getrelativex(h)                 GUI_DIM((gui_widget_isexpanded(h) ? 0 : \
-                                                        (guii_widget_getflag(__GH(h), GUI_FLAG_XPOS_PERCENT) ? (gui_dim_t)((float)GUI_ROUND(__GH(h)->x * guii_widget_getparentinnerwidth(__GH(h))) / 100.0f) : __GH(h)->x) \
+                                                        (guii_widget_getflag(__GH(h), GUI_FLAG_XPOS_PERCENT) ? GUI_DIM_PERCENT(__GH(h)->x, guii_widget_getparentinnerwidth(__GH(h))) : __GH(h)->x) \
                                                     ))
 
 /**
@@ -131,7 +151,7 @@ extern "C" {
  * \hideinitializer
  */
 #define guii_widget_getrelativey(h)                 GUI_DIM(gui_widget_isexpanded(__GH(h)) ? 0 : \
-                                                        (guii_widget_getflag(__GH(h), GUI_FLAG_YPOS_PERCENT) ? (gui_dim_t)((float)GUI_ROUND(__GH(h)->y * guii_widget_getparentinnerheight(__GH(h))) / 100.0f) : __GH(h)->y) \
+                                                        (guii_widget_getflag(__GH(h), GUI_FLAG_YPOS_PERCENT) ? GUI_DIM_PERCENT(__GH(h)->y, guii_widget_getparentinnerheight(__GH(h))) : __GH(h)->y) \
                                                     )
 
 /**
@@ -211,7 +231,8 @@ extern "C" {
  * \retval          Color value
  * \hideinitializer
  */
-#define guii_widget_getcolor(h, index)              (__GH(h)->colors != NULL ? __GH(h)->colors[(uint8_t)(index)] : (__GH(h)->widget->colors != NULL ? __GH(h)->widget->colors[(uint8_t)(index)] : GUI_COLOR_BLACK))
+#define guii_widget_getcolor(h, index)              ((__GH(h)->style != NULL && (uint8_t)(index) < __GH(h)->style->color_count) ? __GH(h)->style->colors[(uint8_t)(index)] : \
+                                                        (__GH(h)->widget->colors != NULL ? __GH(h)->widget->colors[(uint8_t)(index)] : GUI_COLOR_BLACK))
 
 /**
  * \brief           Returns width of parent element. If parent does not exists, it returns LCD width
@@ -331,11 +352,16 @@ extern "C" {
 #define guii_widget_hasalpha(h)                     (guii_widget_isvisible(h) && gui_widget_getalpha(h) < 0xFF)
 
 uint8_t         guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* key);
+uint8_t         guii_widget_processtextkey_ex(gui_handle_p h, guii_keyboard_data_t* key, size_t* pos, int32_t* diff);
+size_t          guii_widget_gettextlength(gui_handle_p h);
+uint8_t         guii_widget_invalidaterect(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height);
+uint8_t         guii_widget_set3dstyle(gui_handle_p h, uint8_t enable);
 
 uint8_t         guii_widget_setparam(gui_handle_p h, uint16_t cfg, const void* data, uint8_t invalidate, uint8_t invalidateparent);
 uint8_t         guii_widget_getparam(gui_handle_p h, uint16_t cfg, void* data);
 gui_dim_t       guii_widget_getparentabsolutex(gui_handle_p h);
 gui_dim_t       guii_widget_getparentabsolutey(gui_handle_p h);
+uint8_t         guii_widget_getabsvisibleposition(gui_handle_p h, gui_dim_t* x1, gui_dim_t* y1, gui_dim_t* x2, gui_dim_t* y2);
 
 /**
  * \}
@@ -349,7 +375,25 @@ gui_dim_t       guii_widget_getparentabsolutey(gui_handle_p h);
 
 void*           gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, float width, float height, gui_handle_p parent, gui_widget_evt_fn evt_fn, uint16_t flags);
 uint8_t         gui_widget_setcolor(gui_handle_p h, uint8_t index, gui_color_t color);
-uint8_t         gui_widget_setstyle(gui_handle_p h, const gui_style_p style);
+
+/**
+ * \}
+ */
+
+/**
+ * \defgroup        GUI_WIDGET_STYLE Style management
+ * \brief           Shared styles for widgets
+ * \{
+ */
+
+gui_style_p     gui_style_create(const gui_color_t* colors, uint8_t color_count);
+uint8_t         gui_style_release(gui_style_p style);
+uint8_t         gui_style_setcolors(gui_style_p style, const gui_color_t* colors, uint8_t color_count);
+uint8_t         gui_style_setfont(gui_style_p style, const gui_font_t* font);
+uint8_t         gui_style_setpadding(gui_style_p style, gui_dim_t x);
+uint8_t         gui_style_set3d(gui_style_p style, uint8_t enable);
+uint8_t         gui_widget_setstyle(gui_handle_p h, gui_style_p style);
+gui_style_p     gui_widget_getstyle(gui_handle_p h);
 
 /**
  * \}
@@ -410,6 +454,9 @@ gui_widget_getheightex(gui_handle_p h, uint8_t in_percent) {
     return GUI_FLOAT(in_percent ? gui_widget_getheightpercent(h) : gui_widget_getheight(h));
 }
 
+uint8_t         gui_widget_setlayout(gui_handle_p h, const gui_layout_t* layout);
+uint8_t         gui_widget_setlayoutweight(gui_handle_p h, uint8_t weight);
+
 uint8_t         gui_widget_setexpanded(gui_handle_p h, uint8_t state);
 uint8_t         gui_widget_toggleexpanded(gui_handle_p h);
 uint8_t         gui_widget_isexpanded(gui_handle_p h);
@@ -481,6 +528,10 @@ uint8_t         gui_widget_invalidate(gui_handle_p h);
 uint8_t         gui_widget_force_invalidate(gui_handle_p h);
 uint8_t         gui_widget_invalidatewithparent(gui_handle_p h);
 uint8_t         gui_widget_setignoreinvalidate(gui_handle_p h, uint8_t en, uint8_t invalidate);
+uint8_t         gui_widget_update_begin(void);
+uint8_t         gui_widget_update_end(void);
+gui_handle_p    gui_widget_create_tree(const gui_widget_tree_t* tree, size_t count, gui_handle_p parent);
+uint8_t         gui_widget_setdeferred(gui_handle_p h, uint8_t release);
 uint8_t         gui_widget_setinvalidatewithparent(gui_handle_p h, uint8_t value);
 uint8_t         gui_widget_setuserdata(gui_handle_p h, void* const data);
 void *          gui_widget_getuserdata(gui_handle_p h);
@@ -554,6 +605,9 @@ void guii_widget_active_set(gui_handle_p h);
 
 //Execute actual widget remove process
 uint8_t guii_widget_executeremove(void);
+
+//Arrange children of widgets with modified layout
+uint8_t guii_widget_executelayout(void);
 #endif /* !__DOXYGEN__ */
 
 /**
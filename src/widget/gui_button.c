@@ -220,13 +220,5 @@ uint8_t
 gui_button_set3dstyle(gui_handle_p h, uint8_t enable) {    
     GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
     
-    if (enable && !guii_widget_getflag(h, GUI_FLAG_3D)) {  /* Enable style */
-        guii_widget_setflag(h, GUI_FLAG_3D);        /* Enable 3D style */
-        gui_widget_invalidate(h);                   /* Invalidate object */
-    } else if (!enable && guii_widget_getflag(h, GUI_FLAG_3D)) {/* Disable style */
-        guii_widget_clrflag(h, GUI_FLAG_3D);        /* Disable 3D style */
-        gui_widget_invalidate(h);                   /* Invalidate object */
-    }
-    
-    return 1;
+    return guii_widget_set3dstyle(h, enable);       /* Shared style is copied when it sets 3D mode */
 }
@@ -331,7 +331,7 @@ gui_debugbox_addstring(gui_handle_p h, const gui_char* text) {
     
     GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
 
-    item = GUI_MEMALLOC(GUI_MEM_ALIGN(sizeof(*item)) + sizeof(*text) * (gui_string_lengthtotal(text) + 1));
+    item = GUI_MEMALLOC_TAG(GUI_MEM_ALIGN(sizeof(*item)) + sizeof(*text) * (gui_string_lengthtotal(text) + 1), GUI_MEM_TAG_ITEM);
     if (item != NULL) {
         item->text = (void *)((char *)item + GUI_MEM_ALIGN(sizeof(*item)));
         gui_string_copy(item->text, text);
@@ -537,7 +537,7 @@ gui_dropdown_addstring(gui_handle_p h, const gui_char* text) {
     
     GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
 
-    item = GUI_MEMALLOC(sizeof(*item));             /* Allocate memory for entry */
+    item = GUI_MEMALLOC_TAG(sizeof(*item), GUI_MEM_TAG_ITEM);   /* Allocate memory for entry */
     if (item != NULL) {
         item->text = (gui_char *)text;
         gui_widget_list_add_item(h, &o->ld, item);  /* Add to linkedlist */
@@ -63,6 +63,13 @@ typedef struct {
     uint8_t flags;                                  /*!< List of widget flags */
     gui_edittext_valign_t valign;                   /*!< Vertical align setup */
     gui_edittext_halign_t halign;                   /*!< Horizontal align setup */
+    
+    size_t* lines;                                  /*!< Byte positions of line starts in text for multi-line mode */
+    size_t lines_cnt;                               /*!< Number of valid entries in lines array */
+    size_t lines_size;                              /*!< Number of allocated entries in lines array */
+    size_t line_top;                                /*!< Index of first visible line */
+    gui_dim_t layout_width;                         /*!< Text width used for current lines layout */
+    const gui_font_t* layout_font;                  /*!< Font used for current lines layout */
 } gui_edittext_t;
 
 #define CFG_MULTILINE       0x01
@@ -97,6 +104,507 @@ gui_widget_t widget = {
 /* Check if edit text is multiline */
 #define is_multiline(o)            (o->flags & GUI_EDITTEXT_FLAG_MULTILINE)
 
+/* Distance between widget border and text area */
+#define TEXT_PADDING                5
+
+/* Number of entries to allocate at a time for lines array */
+#define LINES_ALLOC_STEP            16
+
+/* Get byte from text at position, gap at cursor position is skipped */
+#define text_byte(h, pos)          ((h)->text[(pos) < (h)->textcursor ? (pos) : (pos) + (h)->textgaplen])
+
+/* Get line start position after text modification at position with number of bytes difference */
+#define line_shift(x, pos, diff)   ((x) > (pos) ? (size_t)((int32_t)(x) + (diff)) : (x))
+
+/**
+ * \brief           Get next character from text
+ * \param[in]       h: Widget handle
+ * \param[in,out]   pos: Byte position in text. Set to next character position on return
+ * \param[in]       len: Total number of bytes in text
+ * \return          Character value or `0` if end of text
+ */
+static uint32_t
+text_getch(gui_handle_p h, size_t* pos, size_t len) {
+#if GUI_CFG_USE_UNICODE
+    gui_string_unicode_t s;
+    
+    gui_string_unicode_init(&s);
+    while (*pos < len) {
+        if (gui_string_unicode_decode(&s, text_byte(h, *pos)) == UNICODE_OK) {
+            (*pos)++;
+            return s.res;
+        }
+        (*pos)++;
+    }
+    return 0;
+#else
+    if (*pos < len) {
+        return text_byte(h, (*pos)++);
+    }
+    return 0;
+#endif /* GUI_CFG_USE_UNICODE */
+}
+
+/**
+ * \brief           Get width of text part in units of pixels
+ * \param[in]       h: Widget handle
+ * \param[in]       start: Byte position of first character
+ * \param[in]       end: Byte position after last character
+ * \return          Text width
+ */
+static gui_dim_t
+text_getwidth(gui_handle_p h, size_t start, size_t end) {
+    gui_dim_t w = 0, cw, ch;
+    uint32_t c;
+    
+    while (start < end) {
+        c = text_getch(h, &start, end);
+        gui_text_getcharsize(h->font, c == GUI_KEY_CR ? GUI_KEY_WS : c, &cw, &ch);
+        w += cw;
+    }
+    return w;
+}
+
+/**
+ * \brief           Insert new line start to lines array
+ * \param[in]       h: Widget handle
+ * \param[in]       index: Index in array where to insert
+ * \param[in]       value: Line start byte position
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+lines_insert(gui_handle_p h, size_t index, size_t value) {
+    gui_edittext_t* o = GUI_VP(h);
+    
+    if (o->lines_cnt == o->lines_size) {            /* Check if array is full */
+        if (GUI_MEMREALLOC_MOVABLE(&o->lines, sizeof(*o->lines) * (o->lines_size + LINES_ALLOC_STEP)) == NULL) {
+            return 0;
+        }
+        o->lines_size += LINES_ALLOC_STEP;
+    }
+    if (index < o->lines_cnt) {
+        memmove(&o->lines[index + 1], &o->lines[index], sizeof(*o->lines) * (o->lines_cnt - index));
+    }
+    o->lines[index] = value;
+    o->lines_cnt++;
+    return 1;
+}
+
+/**
+ * \brief           Remove line start from lines array
+ * \param[in]       h: Widget handle
+ * \param[in]       index: Index in array to remove
+ */
+static void
+lines_remove(gui_handle_p h, size_t index) {
+    gui_edittext_t* o = GUI_VP(h);
+    
+    o->lines_cnt--;
+    memmove(&o->lines[index], &o->lines[index + 1], sizeof(*o->lines) * (o->lines_cnt - index));
+}
+
+/**
+ * \brief           Get index of line where text position is
+ * \param[in]       h: Widget handle
+ * \param[in]       pos: Byte position in text
+ * \return          Line index
+ */
+static size_t
+lines_find(gui_handle_p h, size_t pos) {
+    gui_edittext_t* o = GUI_VP(h);
+    size_t l = 0, r = o->lines_cnt, m;
+    
+    while (r - l > 1) {                             /* Binary search for last line start before position */
+        m = (l + r) / 2;
+        if (o->lines[m] <= pos) {
+            l = m;
+        } else {
+            r = m;
+        }
+    }
+    return l;
+}
+
+/**
+ * \brief           Find start of next line in multi-line mode
+ *
+ *                  Line is closed on line feed or when next character does not fit to line.
+ *                  In the later case, line breaks after last white space in line if exists
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       start: Byte position of line start
+ * \param[in]       len: Total number of bytes in text
+ * \param[out]      lf: Set to `1` if line is closed with line feed character
+ * \return          Byte position of next line start
+ */
+static size_t
+layout_line(gui_handle_p h, size_t start, size_t len, uint8_t* lf) {
+    gui_edittext_t* o = GUI_VP(h);
+    size_t pos = start, next, brk = start;
+    gui_dim_t w = 0, cw, chh;
+    uint32_t ch;
+    
+    *lf = 0;
+    while (pos < len) {
+        next = pos;
+        ch = text_getch(h, &next, len);
+        if (ch == GUI_KEY_LF) {                     /* Line feed forces new line */
+            *lf = 1;
+            return next;
+        }
+        gui_text_getcharsize(h->font, ch == GUI_KEY_CR ? GUI_KEY_WS : ch, &cw, &chh);
+        if ((w + cw) >= o->layout_width && pos > start) {   /* Character does not fit to line anymore */
+            return brk > start ? brk : pos;
+        }
+        w += cw;
+        if (ch == GUI_KEY_WS) {
+            brk = next;                             /* Line may break after white space */
+        }
+        pos = next;
+    }
+    return len;
+}
+
+/**
+ * \brief           Build lines layout for entire text
+ * \param[in]       h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+layout_full(gui_handle_p h) {
+    gui_edittext_t* o = GUI_VP(h);
+    size_t len, start = 0;
+    uint8_t lf;
+    
+    len = guii_widget_gettextlength(h);
+    o->lines_cnt = 0;
+    o->layout_width = gui_widget_getwidth(h) - 2 * TEXT_PADDING;
+    o->layout_font = h->font;
+    while (1) {
+        if (!lines_insert(h, o->lines_cnt, start)) {
+            return 0;
+        }
+        start = layout_line(h, start, len, &lf);
+        if (start >= len) {
+            if (lf && !lines_insert(h, o->lines_cnt, len)) {/* Empty line after last line feed */
+                return 0;
+            }
+            break;
+        }
+    }
+    guii_widget_clrflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Layout is valid */
+    return 1;
+}
+
+/**
+ * \brief           Update lines layout after text modification
+ *
+ *                  Layout is rebuilt from line before modified line and stops
+ *                  as soon as new line start matches line start from previous layout
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       pos: Byte position where text was modified
+ * \param[in]       diff: Number of bytes added (positive) or removed (negative)
+ * \param[out]      first: Index of first modified line
+ * \param[out]      last: Index of last modified line
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+layout_update(gui_handle_p h, size_t pos, int32_t diff, size_t* first, size_t* last) {
+    gui_edittext_t* o = GUI_VP(h);
+    size_t len, k, next, end;
+    uint8_t lf;
+    
+    len = guii_widget_gettextlength(h);
+    end = pos + (diff > 0 ? diff : 0);              /* End of modified part in new text */
+    k = lines_find(h, pos);
+    if (k) {                                        /* Previous line may take word from modified line */
+        k--;
+    }
+    *first = k;
+    while (1) {
+        next = layout_line(h, o->lines[k], len, &lf);
+        if (next >= len) {                          /* This is last line */
+            o->lines_cnt = k + 1;
+            if (lf && !lines_insert(h, o->lines_cnt, len)) {
+                return 0;
+            }
+            *last = o->lines_cnt - 1;
+            return 1;
+        }
+        
+        /* Remove line starts which do not exist anymore */
+        while ((k + 1) < o->lines_cnt && line_shift(o->lines[k + 1], pos, diff) < next) {
+            lines_remove(h, k + 1);
+        }
+        if ((k + 1) < o->lines_cnt && line_shift(o->lines[k + 1], pos, diff) == next) {
+            if (next > end) {                       /* Layout after this point is the same as before */
+                for (*last = k++; k < o->lines_cnt; k++) {
+                    o->lines[k] = line_shift(o->lines[k], pos, diff);
+                }
+                return 1;
+            }
+            o->lines[k + 1] = next;
+        } else if (!lines_insert(h, k + 1, next)) {
+            return 0;
+        }
+        k++;
+    }
+}
+
+/**
+ * \brief           Check if lines layout is valid for current widget setup
+ * \param[in]       h: Widget handle
+ * \return          `1` if valid, `0` otherwise
+ */
+static uint8_t
+layout_isvalid(gui_handle_p h) {
+    gui_edittext_t* o = GUI_VP(h);
+    return o->lines != NULL && o->layout_font == h->font
+        && o->layout_width == (gui_widget_getwidth(h) - 2 * TEXT_PADDING)
+        && !guii_widget_getflag(h, GUI_FLAG_TEXT_RELAYOUT);
+}
+
+/**
+ * \brief           Get number of visible lines in multi-line mode
+ * \param[in]       h: Widget handle
+ * \return          Number of visible lines
+ */
+static size_t
+layout_getvisiblelines(gui_handle_p h) {
+    gui_dim_t lh = h->font->size;
+    gui_dim_t hi = gui_widget_getheight(h) - 2 * TEXT_PADDING;
+    
+    return (lh > 0 && hi > lh) ? (size_t)(hi / lh) : 1;
+}
+
+/**
+ * \brief           Get index of first visible line to keep cursor line visible
+ * \param[in]       h: Widget handle
+ * \return          First visible line index
+ */
+static size_t
+layout_gettop(gui_handle_p h) {
+    gui_edittext_t* o = GUI_VP(h);
+    size_t vis, top, cl;
+    
+    vis = layout_getvisiblelines(h);
+    if (o->lines_cnt <= vis) {                      /* Everything fits */
+        return 0;
+    }
+    top = o->line_top;
+    cl = lines_find(h, h->textcursor);              /* Get cursor line */
+    if (cl < top) {
+        top = cl;
+    } else if (cl >= (top + vis)) {
+        top = cl - vis + 1;
+    }
+    if ((top + vis) > o->lines_cnt) {               /* Do not leave empty space at the bottom */
+        top = o->lines_cnt - vis;
+    }
+    return top;
+}
+
+/**
+ * \brief           Get vertical offset of first visible line relative to text area
+ * \param[in]       h: Widget handle
+ * \return          Vertical offset in units of pixels
+ */
+static gui_dim_t
+layout_getyoffset(gui_handle_p h) {
+    gui_edittext_t* o = GUI_VP(h);
+    gui_dim_t th, hi;
+    
+    th = (gui_dim_t)o->lines_cnt * h->font->size;   /* Total text height */
+    hi = gui_widget_getheight(h) - 2 * TEXT_PADDING;
+    if (th >= hi) {                                 /* Text does not fit, align to top */
+        return 0;
+    }
+    if (o->valign == GUI_EDITTEXT_VALIGN_CENTER) {
+        return (hi - th) / 2;
+    } else if (o->valign == GUI_EDITTEXT_VALIGN_BOTTOM) {
+        return hi - th;
+    }
+    return 0;
+}
+
+/**
+ * \brief           Draw text part from continuous memory
+ * \param[in]       disp: Display clipping region
+ * \param[in]       h: Widget handle
+ * \param[in]       start: Start index in text memory
+ * \param[in]       end: End index in text memory
+ * \param[in]       f: Text drawing setup
+ */
+static void
+draw_textpart(const gui_display_t* disp, gui_handle_p h, size_t start, size_t end, gui_draw_text_t* f) {
+    gui_char c;
+    
+    if (start >= end || f->width <= 0) {
+        return;
+    }
+    c = h->text[end];                               /* Terminate text part temporary */
+    h->text[end] = 0;
+    gui_draw_writetext(disp, h->font, &h->text[start], f);
+    h->text[end] = c;
+}
+
+/**
+ * \brief           Draw visible lines in multi-line mode
+ * \param[in]       disp: Display clipping region
+ * \param[in]       h: Widget handle
+ * \param[in]       x: Text area absolute `X` position
+ * \param[in]       y: Text area absolute `Y` position
+ * \param[in]       width: Text area width
+ * \param[in]       height: Text area height
+ */
+static void
+draw_lines(const gui_display_t* disp, gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    gui_edittext_t* o = GUI_VP(h);
+    gui_draw_text_t f;
+    gui_dim_t lx, ly, lh, w1, w2;
+    size_t i, a, b, e, len, cur = h->textcursor;
+    
+    len = guii_widget_gettextlength(h);
+    lh = h->font->size;
+    o->line_top = layout_gettop(h);
+    ly = y + layout_getyoffset(h);
+    
+    gui_draw_text_init(&f);
+    f.lineheight = lh;
+    f.color1 = guii_widget_getcolor(h, GUI_EDITTEXT_COLOR_FG);
+    f.flags |= GUI_FLAG_TEXT_EDITMODE;              /* Keep leading spaces, offsets are calculated with them */
+    for (i = o->line_top; i < o->lines_cnt && ly < (y + height) && ly <= disp->y2; i++, ly += lh) {
+        if ((ly + lh) < disp->y1) {                 /* Line is not inside clipping region */
+            continue;
+        }
+        a = o->lines[i];
+        b = (i + 1) < o->lines_cnt ? o->lines[i + 1] : len;
+        if (b > a && text_byte(h, b - 1) == GUI_KEY_LF) {
+            b--;                                    /* Line feed is not drawn */
+        }
+        
+        /* Line may be split by gap on cursor position */
+        e = b < cur ? b : cur;
+        w1 = a < e ? text_getwidth(h, a, e) : 0;
+        w2 = b > cur ? text_getwidth(h, a > cur ? a : cur, b) : 0;
+        
+        lx = x;
+        if (o->halign == GUI_EDITTEXT_HALIGN_CENTER) {
+            lx += (width - w1 - w2) / 2;
+        } else if (o->halign == GUI_EDITTEXT_HALIGN_RIGHT) {
+            lx += width - w1 - w2;
+        }
+        if (lx < x) {
+            lx = x;
+        }
+        
+        f.y = ly;
+        f.height = (ly + lh) > (y + height) ? (y + height - ly) : lh;
+        if (a < e) {                                /* Part before gap */
+            f.x = lx;
+            f.width = f.color1width = x + width - lx;
+            draw_textpart(disp, h, a, e, &f);
+            lx += w1;
+        }
+        if (b > cur) {                              /* Part after gap */
+            f.x = lx;
+            f.width = f.color1width = x + width - lx;
+            draw_textpart(disp, h, (a > cur ? a : cur) + h->textgaplen, b + h->textgaplen, &f);
+        }
+    }
+}
+
+/**
+ * \brief           Draw single-line text with opened gap at cursor position
+ *
+ *                  Both parts around the gap are drawn directly from text memory,
+ *                  gap is not closed on every redraw while user is typing
+ *
+ * \param[in]       disp: Display clipping region
+ * \param[in]       h: Widget handle
+ * \param[in]       f: Text drawing setup for whole text area
+ */
+static void
+draw_gapline(const gui_display_t* disp, gui_handle_p h, gui_draw_text_t* f) {
+    gui_dim_t x = f->x, width = f->width, w1, w2;
+    size_t len, cur = h->textcursor;
+    uint8_t align = f->align;
+    
+    len = guii_widget_gettextlength(h);
+    w1 = text_getwidth(h, 0, cur);
+    w2 = text_getwidth(h, cur, len);
+    
+    f->align = align & ~GUI_HALIGN_MASK;            /* Parts are positioned manually */
+    if ((w1 + w2) <= width) {                       /* Whole text is visible */
+        if ((align & GUI_HALIGN_MASK) == GUI_HALIGN_CENTER) {
+            f->x += (width - w1 - w2) / 2;
+        } else if ((align & GUI_HALIGN_MASK) == GUI_HALIGN_RIGHT) {
+            f->x += width - w1 - w2;
+        }
+        f->width = f->color1width = x + width - f->x;
+        draw_textpart(disp, h, 0, cur, f);
+        f->x += w1;
+    } else if (w2 < width) {                        /* End of text before gap is visible */
+        f->width = f->color1width = width - w2;     /* Right align flag shows only end of text */
+        draw_textpart(disp, h, 0, cur, f);
+        f->x = x + width - w2;
+    }
+    f->width = f->color1width = x + width - f->x;
+    draw_textpart(disp, h, cur + h->textgaplen, len + h->textgaplen, f);
+}
+
+/**
+ * \brief           Process text change in multi-line mode
+ *
+ *                  Lines layout is updated from modified line only
+ *                  and only modified lines are invalidated
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       pos: Byte position where text was modified
+ * \param[in]       diff: Number of bytes added (positive) or removed (negative)
+ */
+static void
+process_text_change(gui_handle_p h, size_t pos, int32_t diff) {
+    gui_edittext_t* o = GUI_VP(h);
+    size_t first = 0, last = 0, cnt, top;
+    gui_dim_t yoff, lh, hi;
+    
+    cnt = o->lines_cnt;
+    top = o->line_top;
+    yoff = layout_getyoffset(h);
+    if (diff && !layout_update(h, pos, diff, &first, &last)) {
+        GUI_MEMFREE_MOVABLE(&o->lines);             /* Layout is not valid anymore */
+        o->lines_cnt = o->lines_size = 0;
+        gui_widget_invalidate(h);
+        return;
+    }
+    o->line_top = layout_gettop(h);
+    if (o->line_top != top || layout_getyoffset(h) != yoff) {   /* All lines moved */
+        gui_widget_invalidate(h);
+        return;
+    }
+    if (!diff) {                                    /* Only cursor moved */
+        return;
+    }
+    if (cnt != o->lines_cnt) {                      /* Lines after modification moved */
+        last = cnt > o->lines_cnt ? cnt : o->lines_cnt;
+    }
+    if (first < top) {
+        first = top;
+    }
+    if (last < first) {
+        return;
+    }
+    lh = h->font->size;
+    hi = gui_widget_getheight(h) - TEXT_PADDING;
+    yoff += TEXT_PADDING + (gui_dim_t)(first - top) * lh;
+    if (yoff < hi) {
+        guii_widget_invalidaterect(h, TEXT_PADDING, yoff, gui_widget_getwidth(h) - 2 * TEXT_PADDING,
+            GUI_MIN((gui_dim_t)(last - first + 1) * lh, hi - yoff));
+    }
+}
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -119,10 +627,12 @@ gui_edittext_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
             gui_widget_param* p = GUI_EVT_PARAMTYPE_WIDGETPARAM(param);
             switch (p->type) {
                 case CFG_MULTILINE:
-                    if (*(uint8_t *)p->data && !is_multiline(h)) {
+                    if (*(uint8_t *)p->data && !is_multiline(o)) {
                         o->flags |= GUI_EDITTEXT_FLAG_MULTILINE;
-                    } else if (!*(uint8_t *)p->data && is_multiline(h)) {
+                    } else if (!*(uint8_t *)p->data && is_multiline(o)) {
                         o->flags &= ~GUI_EDITTEXT_FLAG_MULTILINE;
+                        GUI_MEMFREE_MOVABLE(&o->lines); /* Lines layout is not used anymore */
+                        o->lines_cnt = o->lines_size = 0;
                     }
                     break; /* Set max X value to widget */
                 case CFG_HALIGN: 
@@ -154,25 +664,42 @@ gui_edittext_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
             
             if (gui_widget_isfontandtextset(h)) {   /* Ready to write string */
                 gui_draw_text_t f;
+                
+                /* Draw only visible lines directly from edited text */
+                if (is_multiline(o) && guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC)
+                    && (layout_isvalid(h) || layout_full(h))) {
+                    draw_lines(disp, h, x + TEXT_PADDING, y + TEXT_PADDING, width - 2 * TEXT_PADDING, height - 2 * TEXT_PADDING);
+                    return 1;
+                }
+
                 gui_draw_text_init(&f);             /* Init font drawing */
                 
-                f.x = x + 5;
-                f.y = y + 5;
-                f.width = width - 10;
-                f.height = height - 10;
+                f.x = x + TEXT_PADDING;
+                f.y = y + TEXT_PADDING;
+                f.width = width - 2 * TEXT_PADDING;
+                f.height = height - 2 * TEXT_PADDING;
                 f.align = (uint8_t)o->halign | (uint8_t)o->valign;
                 f.color1width = f.width;
                 f.color1 = guii_widget_getcolor(h, GUI_EDITTEXT_COLOR_FG);
                 f.flags |= GUI_FLAG_TEXT_RIGHTALIGN | GUI_FLAG_TEXT_EDITMODE;
                 
-                if (is_multiline(h)) {
+                if (is_multiline(o)) {
                     f.flags |= GUI_FLAG_TEXT_MULTILINE; /* Set multiline flag for widget */
+                } else if (h->textgaplen) {         /* Text is being edited, do not close the gap */
+                    draw_gapline(disp, h, &f);
+                    return 1;
                 }
                 
                 gui_draw_writetext(disp, gui_widget_getfont(h), gui_widget_gettext(h), &f);
             }
             return 1;
         }
+        case GUI_EVT_REMOVE: {
+            if (o->lines != NULL) {
+                GUI_MEMFREE_MOVABLE(&o->lines);
+            }
+            return 1;
+        }
 #if GUI_CFG_USE_KEYBOARD
         case GUI_EVT_FOCUSIN:
             gui_keyboard_show(h);
@@ -182,7 +709,14 @@ gui_edittext_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
             return 1;
         case GUI_EVT_KEYPRESS: {
             guii_keyboard_data_t* kb = GUI_EVT_PARAMTYPE_KEYBOARD(param);    /* Get keyboard data */
-            if (guii_widget_processtextkey(h, kb)) {
+            if (is_multiline(o) && layout_isvalid(h)) { /* Update only modified lines */
+                size_t pos;
+                int32_t diff;
+                if (guii_widget_processtextkey_ex(h, kb, &pos, &diff)) {
+                    process_text_change(h, pos, diff);
+                    GUI_EVT_RESULTTYPE_KEYBOARD(result) = keyHANDLED;
+                }
+            } else if (guii_widget_processtextkey(h, kb)) {
                 GUI_EVT_RESULTTYPE_KEYBOARD(result) = keyHANDLED;
             }
             return 1;
@@ -315,36 +315,38 @@ gui_graph_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const
             return 1;
         }
         case GUI_EVT_TOUCHMOVE: {
-            guii_touch_data_t* ts = GUI_EVT_PARAMTYPE_TOUCH(param);  /* Get touch data */
+            GUI_EVT_RESULTTYPE_TOUCH(result) = touchHANDLED;  /* Keep touch on graph, movement is handled by gestures */
+            return 1;
+        }
+        case GUI_EVT_TOUCHEND:
+            return 1;
+        case GUI_EVT_PAN: {                         /* Move graph with single touch */
+            gui_gesture_t* gs = &GUI_EVT_PARAMTYPE_TOUCH(param)->gesture;
             float diff, step;
             
-            if (ts->ts.count == 1) {                /* Move graph on single widget */                
-                step = (float)(gui_widget_getwidth(h) - g->border[GUI_GRAPH_BORDER_LEFT] - g->border[GUI_GRAPH_BORDER_RIGHT]) / (float)(g->visible_max_x - g->visible_min_x);
-                diff = (float)(ts->x_diff[0]) / step;
-                g->visible_min_x -= diff;
-                g->visible_max_x -= diff;
-                
-                step = (float)(gui_widget_getheight(h) - g->border[GUI_GRAPH_BORDER_TOP] - g->border[GUI_GRAPH_BORDER_BOTTOM]) / (float)(g->visible_max_y - g->visible_min_y);
-                diff = (float)(ts->y_diff[0]) / step;
-                g->visible_min_y += diff;
-                g->visible_max_y += diff;
-#if GUI_CFG_TOUCH_MAX_PRESSES > 1
-            } else if (ts->ts.count == 2) {         /* Scale widget on multiple touches */
-                float centerX, centerY, zoom;
-                
-                gui_math_centerofxy(ts->x_rel[0], ts->y_rel[0], ts->x_rel[1], ts->y_rel[1], &centerX, &centerY);    /* Calculate center position between points */
-                zoom = ts->distance / ts->distance_old; /* Calculate zoom value */
-                
-                graph_zoom(h, zoom, (float)centerX / (float)gui_widget_getwidth(h), (float)centerY / (float)gui_widget_getheight(h));
-#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
-            }
-            gui_widget_invalidate(h);               /* Invalidate widget */
+            step = (float)(gui_widget_getwidth(h) - g->border[GUI_GRAPH_BORDER_LEFT] - g->border[GUI_GRAPH_BORDER_RIGHT]) / (float)(g->visible_max_x - g->visible_min_x);
+            diff = (float)(gs->dx) / step;
+            g->visible_min_x -= diff;
+            g->visible_max_x -= diff;
             
-            GUI_EVT_RESULTTYPE_TOUCH(result) = touchHANDLED;  /* Set touch status */
+            step = (float)(gui_widget_getheight(h) - g->border[GUI_GRAPH_BORDER_TOP] - g->border[GUI_GRAPH_BORDER_BOTTOM]) / (float)(g->visible_max_y - g->visible_min_y);
+            diff = (float)(gs->dy) / step;
+            g->visible_min_y += diff;
+            g->visible_max_y += diff;
+            gui_widget_invalidate(h);               /* Invalidate widget */
             return 1;
         }
-        case GUI_EVT_TOUCHEND:
+#if GUI_CFG_TOUCH_MAX_PRESSES > 1
+        case GUI_EVT_PINCH: {                       /* Scale graph with 2 touches */
+            gui_gesture_t* gs = &GUI_EVT_PARAMTYPE_TOUCH(param)->gesture;
+            
+            if (gs->state != GUI_GESTURE_STATE_END) {
+                graph_zoom(h, gs->scale, (float)gs->x / (float)gui_widget_getwidth(h), (float)gs->y / (float)gui_widget_getheight(h));
+                gui_widget_invalidate(h);           /* Invalidate widget */
+            }
             return 1;
+        }
+#endif /* GUI_CFG_TOUCH_MAX_PRESSES > 1 */
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_EVT_DBLCLICK:
             graph_reset(h);                         /* Reset zoom */
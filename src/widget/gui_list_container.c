@@ -79,17 +79,22 @@ calculate_limits(gui_handle_p h) {
     gui_dim_t x, y, width, height, cmx = 0, cmy = 0;
     gui_listcontainer_t* o = GUI_VP(h);
     
-    /* Scan all children widgets and check for maximal possible scroll */
-    for (w = gui_linkedlist_widgetgetnext(h, NULL); w != NULL;
-            w = gui_linkedlist_widgetgetnext(NULL, w)) {
+    if (h->layout != NULL) {                        /* Size of children is known from layout */
+        cmx = h->layout_width;
+        cmy = h->layout_height;
+    } else {
+        /* Scan all children widgets and check for maximal possible scroll */
+        for (w = gui_linkedlist_widgetgetnext(h, NULL); w != NULL;
+                w = gui_linkedlist_widgetgetnext(NULL, w)) {
 
-        x = guii_widget_getrelativex(w);
-        y = guii_widget_getrelativey(w);
-        width = gui_widget_getwidth(w);
-        height = gui_widget_getheight(w);
+            x = guii_widget_getrelativex(w);
+            y = guii_widget_getrelativey(w);
+            width = gui_widget_getwidth(w);
+            height = gui_widget_getheight(w);
 
-        cmx = GUI_MAX(cmx, x + width);
-        cmy = GUI_MAX(cmy, y + height);
+            cmx = GUI_MAX(cmx, x + width);
+            cmy = GUI_MAX(cmy, y + height);
+        }
     }
 
     width = gui_widget_getinnerwidth(h);  
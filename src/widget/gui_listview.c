@@ -360,7 +360,7 @@ gui_listview_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
                 for (i = 0; i < o->col_count; i++) {
                     GUI_MEMFREE(o->cols[i]);
                 }
-                GUI_MEMFREE(o->cols);
+                GUI_MEMFREE_MOVABLE(&o->cols);
             }
             return 1;
         }
@@ -542,15 +542,14 @@ uint8_t
 gui_listview_addcolumn(gui_handle_p h, const gui_char* text, gui_dim_t width) {
     uint8_t ret = 0;
     gui_listview_col_t* col;
-    gui_listview_col_t** cols;
     gui_listview_t* o = GUI_VP(h);
     
     GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
 
-    cols = GUI_MEMREALLOC(o->cols, sizeof(*o->cols) * (o->col_count + 2));    /* Allocate new memory block for new pointers of columns */
-    if (cols != NULL) {
-        o->cols = cols;                       /* Save new pointer of memory */
-        col = GUI_MEMALLOC(sizeof(*col));       /* Allocate memory for new column structure */
+    /* Array of column pointers is only referenced from widget and may be moved by compaction */
+    if ((o->cols == NULL && GUI_MEMALLOC_MOVABLE(&o->cols, sizeof(*o->cols) * 2, GUI_MEM_TAG_ITEM) != NULL) ||
+        (o->cols != NULL && GUI_MEMREALLOC_MOVABLE(&o->cols, sizeof(*o->cols) * (o->col_count + 2)) != NULL)) {
+        col = GUI_MEMALLOC_TAG(sizeof(*col), GUI_MEM_TAG_ITEM);     /* Allocate memory for new column structure */
         if (col != NULL) {
             o->cols[o->col_count++] = col;  /* Add column to array list */
             o->cols[o->col_count] = NULL;   /* Add zero to the end of array */
@@ -599,7 +598,7 @@ gui_listview_addrow(gui_handle_p h) {
     
     GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
 
-    row = GUI_MEMALLOC(sizeof(*row));               /* Allocate memory for new row(s) */
+    row = GUI_MEMALLOC_TAG(sizeof(*row), GUI_MEM_TAG_ITEM);     /* Allocate memory for new row(s) */
     if (row != NULL) {
         gui_widget_list_add_item(h, &o->ld, row);
     }
@@ -654,7 +653,7 @@ gui_listview_setitemstring(gui_handle_p h, gui_listview_row_p row, uint16_t col,
     col++;
     while (col--) {                                 /* Find right column */
         if (item == NULL) {
-            item = GUI_MEMALLOC(sizeof(*item));     /* Allocate for item */
+            item = GUI_MEMALLOC_TAG(sizeof(*item), GUI_MEM_TAG_ITEM);   /* Allocate for item */
             if (item == NULL) {
                 break;
             }
@@ -60,9 +60,12 @@ typedef struct {
     int32_t max;                                    /*!< High value for progress bar */
     int32_t currentvalue;                           /*!< Current value for progress bar */
     int32_t desiredvalue;                           /*!< Desired value, set by used */
+    gui_anim_t anim;                                /*!< Animation from current to desired value */
     uint8_t flags;                                  /*!< flags variable */
 } gui_progbar_t;
 
+#define PROGBAR_ANIM_DURATION   300                 /*!< Duration of value change animation in units of milliseconds */
+
 #define CFG_VALUE           0x01
 #define CFG_MIN             0x02
 #define CFG_MAX             0x03
@@ -107,9 +110,10 @@ set_value(gui_handle_p h, int32_t val) {
         } else if (o->currentvalue > o->max) {
             o->currentvalue = o->max;
         }
-        if (is_anim(h) && h->timer != NULL) {       /* In case of animation and timer availability */
-            guii_timer_start(h->timer);             /* Start timer */
+        if (is_anim(h)) {                           /* Animate from current to desired value */
+            guii_anim_start(&o->anim, &o->currentvalue, o->desiredvalue, PROGBAR_ANIM_DURATION, GUI_ANIM_EASE_OUT);
         } else {
+            guii_anim_stop(&o->anim);
             o->currentvalue = o->desiredvalue;      /* Set values to the same */
         }
         gui_widget_invalidate(h);
@@ -119,24 +123,6 @@ set_value(gui_handle_p h, int32_t val) {
     return 0;
 }
 
-/* Timer callback for widget */
-static void
-timer_callback(gui_timer_t* t) {
-    gui_handle_p h = guii_timer_getparams(t);       /* Get timer parameters */
-    gui_progbar_t* o = GUI_VP(h);
-    if (h != NULL) {
-        if (o->currentvalue != o->desiredvalue) {   /* Check difference */
-            if (o->currentvalue > o->desiredvalue) {
-                o->currentvalue--;
-            } else {
-                o->currentvalue++;
-            }
-            gui_widget_invalidate(h);
-            guii_timer_start(t);
-        }
-    }
-}
-
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -153,6 +139,7 @@ gui_progbar_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* cons
         case GUI_EVT_PRE_INIT: {
             o->min = o->currentvalue = 0;
             o->max = 100;
+            guii_anim_init(&o->anim, h, NULL, NULL);
             set_value(h, 50);
             return 1;
         }
@@ -190,18 +177,14 @@ gui_progbar_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* cons
                     break;
                 case CFG_ANIM:
                     if (*(uint8_t *)v->data) {
-                        if (h->timer == NULL) {
-                            h->timer = guii_timer_create(10, timer_callback, h);    /* Create animation timer */
-                        }
-                        if (h->timer != NULL) { /* Check timer response */
-                            o->flags |= GUI_FLAG_PROGBAR_ANIMATE;   /* Enable animations */
-                        }
+                        o->flags |= GUI_FLAG_PROGBAR_ANIMATE;   /* Enable animations */
                     } else {
                         o->flags &= ~GUI_FLAG_PROGBAR_ANIMATE;  /* Disable animation */
-                        if (h->timer != NULL) {
-                            guii_timer_remove(&h->timer);   /* Remove timer */
+                        guii_anim_stop(&o->anim);
+                        if (o->currentvalue != o->desiredvalue) {
+                            o->currentvalue = o->desiredvalue;  /* Jump to desired value */
+                            gui_widget_invalidate(h);
                         }
-                        set_value(h, o->desiredvalue);  /* Reset value */
                     }
                     break;
                 default: break;
@@ -47,8 +47,9 @@ typedef struct {
     int32_t value;                                  /*!< Current value for slider */
     gui_slider_mode_t mode;                         /*!< Slider mode */
     
-    uint8_t max_size;                               /*!< Max size for animation */
-    uint8_t current_size;                           /*!< Current size for animation */
+    int32_t max_size;                               /*!< Max size for animation */
+    int32_t current_size;                           /*!< Current size for animation */
+    gui_anim_t anim;                                /*!< Circle size animation */
     
     uint8_t flags;                                  /*!< Widget flags */
 } gui_slider_t;
@@ -58,6 +59,8 @@ typedef struct {
 #define CFG_MIN             0x03
 #define CFG_MAX             0x04
 
+#define SLIDER_ANIM_DURATION    120                 /*!< Duration of circle size animation in units of milliseconds */
+
 static uint8_t gui_slider_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const param, gui_evt_result_t* const result);
 
 /**
@@ -159,29 +162,6 @@ touch_handle(gui_handle_p h, guii_touch_data_t* ts) {
     return set_value(h, value);                     /* Set new value */
 }
 
-/* Timer callback function for slider widget */
-static void
-timer_callback(gui_timer_t* timer) {
-    gui_slider_t* o;
-    gui_handle_p h = guii_timer_getparams(timer);   /* Get user parameters */
-    
-    o = GUI_VP(h);
-    
-    if (guii_widget_isactive(o)) {                  /* Timer is in focus */
-        if (o->current_size < o->max_size) {
-            o->current_size++;
-            gui_widget_invalidate(h);
-        }
-    } else {
-        if (o->current_size > 0) {
-            o->current_size--;
-            gui_widget_invalidate(h);
-        } else {
-            guii_timer_stop(timer);
-        }
-    }
-}
-
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -202,10 +182,7 @@ gui_slider_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const
             
             o->max_size = 4;
             o->current_size = 0;
-            h->timer = guii_timer_create(30, timer_callback, o);    /* Create timer for widget, when widget is deleted, timer will be automatically deleted too */
-            if (h->timer == NULL) {                 /* Check if timer created */
-                GUI_EVT_RESULTTYPE_U8(result) = 0;   /* Failed, widget will be deleted */
-            }
+            guii_anim_init(&o->anim, h, NULL, NULL);
             return 1;
         }
         case GUI_EVT_SETPARAM: {                     /* Set parameter for widget */
@@ -318,10 +295,11 @@ gui_slider_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const
             return 1;
 #endif /* GUI_CFG_USE_TOUCH */
         case GUI_EVT_ACTIVEIN: {
-            guii_timer_startperiodic(h->timer);     /* Start animation timer */
+            guii_anim_start(&o->anim, &o->current_size, o->max_size, SLIDER_ANIM_DURATION, GUI_ANIM_EASE_OUT);
             return 1;
         }
         case GUI_EVT_ACTIVEOUT: {
+            guii_anim_start(&o->anim, &o->current_size, 0, SLIDER_ANIM_DURATION, GUI_ANIM_EASE_IN);
             gui_widget_invalidate(h);               /* Invalidate widget */
             return 1;
         }
@@ -35,6 +35,8 @@
 #include "gui/gui_private.h"
 #include "widget/gui_textview.h"
 
+#define GUI_TEXTVIEW_FLAG_VIRTUAL       0x01    /*!< Text is drawn in virtual mode using lines index */
+
 /**
  * \ingroup         GUI_TEXTVIEW
  * \brief           Textview object structure
@@ -45,10 +47,23 @@ typedef struct {
     gui_textalign_valign_t valign;                  /*!< Vertical text align */
     gui_textalign_halign_t halign;                  /*!< Horizontal text align */
     uint8_t flags;                                  /*!< Widget flags */
+    
+    gui_textview_read_fn read_fn;                   /*!< Data read callback in virtual mode. When `NULL`, widget text is used */
+    size_t data_len;                                /*!< Total number of bytes of data in virtual mode */
+    size_t indexed;                                 /*!< Number of bytes of data already added to lines index */
+    size_t* lines;                                  /*!< Lines index, byte offsets of line starts in data */
+    size_t lines_cnt;                               /*!< Number of valid entries in lines index */
+    size_t lines_size;                              /*!< Number of allocated entries in lines index */
+    size_t top;                                     /*!< Index of first visible line */
 } gui_textview_t;
 
 #define CFG_VALIGN          0x01
 #define CFG_HALIGN          0x02
+#define CFG_VIRTUAL         0x03
+#define CFG_TOPLINE         0x04
+
+/* Number of entries to allocate at a time for lines index */
+#define LINES_ALLOC_STEP    32
 
 static uint8_t gui_textview_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const param, gui_evt_result_t* const result);
 
@@ -75,6 +90,178 @@ gui_widget_t widget = {
 };
 #define o                   ((gui_textview_t *)(h))
 
+/* Check if text view is in virtual mode */
+#define is_virtual(h)       (o->flags & GUI_TEXTVIEW_FLAG_VIRTUAL)
+
+/**
+ * \brief           Read data in virtual mode
+ * \param[in]       h: Widget handle
+ * \param[in]       offset: Byte offset in data
+ * \param[out]      buff: Output buffer
+ * \param[in]       len: Number of bytes to read
+ * \return          Number of bytes read
+ */
+static size_t
+data_read(gui_handle_p h, size_t offset, gui_char* buff, size_t len) {
+    if (offset >= o->data_len) {
+        return 0;
+    }
+    if ((offset + len) > o->data_len) {
+        len = o->data_len - offset;
+    }
+    if (o->read_fn != NULL) {                       /* Read data from user */
+        return o->read_fn(h, offset, buff, len);
+    }
+    memcpy(buff, gui_widget_gettext(h) + offset, len);
+    return len;
+}
+
+/**
+ * \brief           Reset lines index
+ * \param[in]       h: Widget handle
+ */
+static void
+index_reset(gui_handle_p h) {
+    o->indexed = 0;
+    o->lines_cnt = 0;
+    if (o->lines != NULL) {
+        o->lines_cnt = 1;                           /* First line always starts at the beginning */
+        o->lines[0] = 0;
+    }
+}
+
+/**
+ * \brief           Add lines of data which are not indexed yet
+ *
+ *                  Only data after last indexed byte is scanned,
+ *                  thus appending data to text view does not scan entire data again
+ *
+ * \param[in]       h: Widget handle
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+index_extend(gui_handle_p h) {
+    gui_char buff[32];
+    size_t len, i;
+    
+    if (o->lines == NULL || o->indexed > o->data_len) { /* First time or data got shorter */
+        if (o->lines == NULL) {
+            if (GUI_MEMALLOC_MOVABLE(&o->lines, sizeof(*o->lines) * LINES_ALLOC_STEP, GUI_MEM_TAG_TEXT) == NULL) {
+                return 0;
+            }
+            o->lines_size = LINES_ALLOC_STEP;
+        }
+        index_reset(h);
+    }
+    while (o->indexed < o->data_len) {
+        len = data_read(h, o->indexed, buff, sizeof(buff));
+        if (!len) {
+            break;
+        }
+        for (i = 0; i < len; i++) {
+            if (buff[i] != GUI_KEY_LF) {
+                continue;
+            }
+            if (o->lines_cnt == o->lines_size) {    /* Make more space for lines */
+                if (GUI_MEMREALLOC_MOVABLE(&o->lines, sizeof(*o->lines) * (o->lines_size + LINES_ALLOC_STEP)) == NULL) {
+                    o->indexed += i;                /* Continue on next try from this line feed */
+                    return 0;
+                }
+                o->lines_size += LINES_ALLOC_STEP;
+            }
+            o->lines[o->lines_cnt++] = o->indexed + i + 1;  /* Next line starts after line feed */
+        }
+        o->indexed += len;
+    }
+    return 1;
+}
+
+/**
+ * \brief           Get number of lines in virtual mode
+ * \note            Empty line after last line feed is not counted
+ * \param[in]       h: Widget handle
+ * \return          Number of lines
+ */
+static size_t
+index_getlinecount(gui_handle_p h) {
+    if (o->lines_cnt > 1 && o->lines[o->lines_cnt - 1] >= o->data_len) {
+        return o->lines_cnt - 1;
+    }
+    return o->lines_cnt;
+}
+
+/**
+ * \brief           Draw visible lines in virtual mode
+ *
+ *                  Drawing starts directly at first visible line from lines index,
+ *                  lines before it are neither read nor measured
+ *
+ * \param[in]       disp: Display clipping region
+ * \param[in]       h: Widget handle
+ * \param[in]       f: Text drawing setup for text area
+ */
+static void
+draw_lines(const gui_display_t* disp, gui_handle_p h, gui_draw_text_t* f) {
+    gui_char buff[GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN + 1];
+    gui_dim_t y, bottom, lh;
+    size_t i, cnt, start, len, vis;
+    
+    lh = gui_widget_getfont(h)->size;
+    if (lh <= 0) {
+        return;
+    }
+    cnt = index_getlinecount(h);
+    vis = f->height / lh;
+    if (o->top + vis > cnt) {                       /* Do not scroll after last line */
+        o->top = cnt > vis ? cnt - vis : 0;
+    }
+    
+    y = f->y;
+    bottom = f->y + f->height;
+    if (cnt < vis) {                                /* Apply vertical align when all lines fit */
+        if ((o->valign & GUI_VALIGN_MASK) == GUI_VALIGN_CENTER) {
+            y += (f->height - (gui_dim_t)cnt * lh) / 2;
+        } else if ((o->valign & GUI_VALIGN_MASK) == GUI_VALIGN_BOTTOM) {
+            y += f->height - (gui_dim_t)cnt * lh;
+        }
+    }
+    
+    f->flags = 0;                                   /* Each line is drawn separately */
+    f->align = (uint8_t)o->halign;
+    f->lineheight = lh;
+    for (i = o->top; i < cnt && y < bottom && y <= disp->y2; i++, y += lh) {
+        if ((y + lh) < disp->y1) {                  /* Line is not in clipping region */
+            continue;
+        }
+        start = o->lines[i];
+        len = ((i + 1) < o->lines_cnt ? o->lines[i + 1] : o->data_len) - start;
+        if (len > GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN) {   /* Long line is truncated */
+            len = data_read(h, start, buff, GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN + 1);
+            if (len > GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN) {
+                len = GUI_CFG_WIDGET_TEXTVIEW_LINE_LEN;
+#if GUI_CFG_USE_UNICODE
+                while (len && (buff[len] & 0xC0) == 0x80) { /* Do not split UTF-8 character */
+                    len--;
+                }
+#endif /* GUI_CFG_USE_UNICODE */
+            }
+        } else {
+            len = data_read(h, start, buff, len);
+        }
+        while (len && (buff[len - 1] == GUI_KEY_LF || buff[len - 1] == GUI_KEY_CR)) {
+            len--;                                  /* Line end characters are not drawn */
+        }
+        if (!len) {
+            continue;
+        }
+        buff[len] = 0;
+        
+        f->y = y;
+        f->height = (y + lh) > bottom ? (bottom - y) : lh;
+        gui_draw_writetext(disp, gui_widget_getfont(h), buff, f);
+    }
+}
+
 /**
  * \brief           Default widget callback function
  * \param[in]       h: Widget handle
@@ -85,6 +272,9 @@ gui_widget_t widget = {
  */
 static uint8_t
 gui_textview_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* const param, gui_evt_result_t* const result) {
+#if GUI_CFG_USE_TOUCH
+    static gui_dim_t ty;
+#endif /* GUI_CFG_USE_TOUCH */
     switch (evt) {
         case GUI_EVT_PRE_INIT: {
             gui_widget_setpadding(h, 3);
@@ -99,6 +289,20 @@ gui_textview_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
                 case CFG_VALIGN: 
                     o->valign = *(gui_textalign_valign_t *)p->data;
                     break;
+                case CFG_VIRTUAL:
+                    if (*(uint8_t *)p->data) {
+                        o->flags |= GUI_TEXTVIEW_FLAG_VIRTUAL;
+                        guii_widget_setflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Build index from widget text */
+                    } else {
+                        o->flags &= ~GUI_TEXTVIEW_FLAG_VIRTUAL;
+                        o->read_fn = NULL;
+                        GUI_MEMFREE_MOVABLE(&o->lines);
+                        o->lines_cnt = o->lines_size = 0;
+                    }
+                    break;
+                case CFG_TOPLINE:
+                    o->top = *(size_t *)p->data;
+                    break;
                 default: break;
             }
             GUI_EVT_RESULTTYPE_U8(result) = 1;   /* Save result */
@@ -109,7 +313,12 @@ gui_textview_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
             gui_dim_t x, y, wi, hi;
             gui_color_t bg;
             
-            if (gui_widget_isfontandtextset(h)) {
+            if (is_virtual(h) && o->read_fn == NULL && guii_widget_getflag(h, GUI_FLAG_TEXT_RELAYOUT)) {
+                guii_widget_clrflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Widget text has been replaced */
+                index_reset(h);
+                o->data_len = h->text != NULL ? gui_string_lengthtotal(gui_widget_gettext(h)) : 0;
+            }
+            if (is_virtual(h) ? (h->font != NULL && o->data_len) : gui_widget_isfontandtextset(h)) {
                 gui_draw_text_t f;
                 
                 x = gui_widget_getabsolutex(h);
@@ -133,22 +342,59 @@ gui_textview_callback(gui_handle_p h, gui_widget_evt_t evt, gui_evt_param_t* con
                 f.flags |= GUI_FLAG_TEXT_MULTILINE; /* Enable multiline */
                 f.color1width = f.width;
                 f.color1 = guii_widget_getcolor(h, GUI_TEXTVIEW_COLOR_TEXT);
-                gui_draw_writetext(disp, gui_widget_getfont(h), gui_widget_gettext(h), &f);
+                if (is_virtual(h)) {
+                    index_extend(h);                /* Index appended data */
+                    draw_lines(disp, h, &f);
+                } else {
+                    gui_draw_writetext(disp, gui_widget_getfont(h), gui_widget_gettext(h), &f);
+                }
             }
             return 1;
         }
 #if GUI_CFG_USE_KEYBOARD
         case GUI_EVT_KEYPRESS: {
             guii_keyboard_data_t* kb = GUI_EVT_PARAMTYPE_KEYBOARD(param);    /* Get keyboard data */
-            if (guii_widget_processtextkey(h, kb)) {
+            if (!is_virtual(h) && guii_widget_processtextkey(h, kb)) {
                 GUI_EVT_RESULTTYPE_KEYBOARD(result) = keyHANDLED;
             }
             return 1;
         }
 #endif /* GUI_CFG_USE_KEYBOARD */
+#if GUI_CFG_USE_TOUCH
+        case GUI_EVT_TOUCHSTART: {
+            if (is_virtual(h)) {                    /* Scroll lines in virtual mode */
+                ty = GUI_EVT_PARAMTYPE_TOUCH(param)->y_rel[0];
+                GUI_EVT_RESULTTYPE_TOUCH(result) = touchHANDLED;
+                return 1;
+            }
+            return 0;
+        }
+        case GUI_EVT_TOUCHMOVE: {
+            guii_touch_data_t* ts = GUI_EVT_PARAMTYPE_TOUCH(param);  /* Get touch data */
+            if (!is_virtual(h)) {
+                return 0;
+            }
+            if (h->font != NULL && GUI_ABS(ty - ts->y_rel[0]) > h->font->size) {
+                if ((ty - ts->y_rel[0]) > 0) {
+                    o->top++;
+                } else if (o->top) {
+                    o->top--;
+                }
+                ty = ts->y_rel[0];
+                gui_widget_invalidate(h);
+            }
+            return 1;
+        }
+#endif /* GUI_CFG_USE_TOUCH */
         case GUI_EVT_CLICK: {
             return 1;
         }
+        case GUI_EVT_REMOVE: {
+            if (o->lines != NULL) {
+                GUI_MEMFREE_MOVABLE(&o->lines);
+            }
+            return 1;
+        }
         default:                                    /* Handle default option */
             GUI_UNUSED3(h, param, result);          /* Unused elements to prevent compiler warnings */
             return 0;                               /* Command was not processed */
@@ -215,3 +461,109 @@ gui_textview_sethalign(gui_handle_p h, gui_textalign_halign_t align) {
     GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
     return guii_widget_setparam(h, CFG_HALIGN, &align, 1, 1);   /* Set parameter */
 }
+
+/**
+ * \brief           Enable or disable virtual mode for large texts
+ *
+ *                  In virtual mode, text is split to lines by line feed characters only
+ *                  and index of line starts is built once. Only visible lines are read and drawn,
+ *                  text is not wrapped and lines wider than widget are cut.
+ *
+ *                  Widget text is used as data source, see \ref gui_textview_setreadcallback for external data
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       en: Set to `1` to enable or `0` to disable virtual mode
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_textview_setvirtual(gui_handle_p h, uint8_t en) {
+    GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
+    return guii_widget_setparam(h, CFG_VIRTUAL, &en, 1, 0);
+}
+
+/**
+ * \brief           Set read callback to get data in virtual mode
+ *
+ *                  Data does not need to be in memory, only visible lines are read from callback
+ *
+ * \note            This function enables virtual mode
+ * \param[in]       h: Widget handle
+ * \param[in]       read_fn: Read callback function. Set to `NULL` to use widget text
+ * \param[in]       len: Total number of bytes available to read
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_textview_setreadcallback(gui_handle_p h, gui_textview_read_fn read_fn, size_t len) {
+    gui_textview_t* ob = GUI_VP(h);
+    GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
+    
+    gui_textview_setvirtual(h, 1);                  /* Make sure virtual mode is active */
+    ob->read_fn = read_fn;
+    ob->data_len = len;
+    ob->indexed = ob->data_len + 1;                 /* Force index rebuild on next draw */
+    if (read_fn != NULL) {
+        guii_widget_clrflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Widget text is not used */
+    } else {
+        guii_widget_setflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Build index from widget text */
+    }
+    gui_widget_invalidate(h);
+    return 1;
+}
+
+/**
+ * \brief           Set new data length in virtual mode after data has been appended
+ *
+ *                  Only appended data are added to lines index.
+ *                  When new length is shorter than before, index is built again
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       len: New total number of bytes of data
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_textview_setdatalength(gui_handle_p h, size_t len) {
+    gui_textview_t* ob = GUI_VP(h);
+    GUI_ASSERTPARAMS(h != NULL && h->widget == &widget && (ob->flags & GUI_TEXTVIEW_FLAG_VIRTUAL));
+    
+    if (ob->data_len != len) {
+        ob->data_len = len;
+        gui_widget_invalidate(h);
+    }
+    return 1;
+}
+
+/**
+ * \brief           Set first visible line in virtual mode
+ * \param[in]       h: Widget handle
+ * \param[in]       line: Line index
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_textview_settopline(gui_handle_p h, size_t line) {
+    GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
+    return guii_widget_setparam(h, CFG_TOPLINE, &line, 1, 0);
+}
+
+/**
+ * \brief           Get first visible line in virtual mode
+ * \param[in]       h: Widget handle
+ * \return          First visible line index
+ */
+size_t
+gui_textview_gettopline(gui_handle_p h) {
+    gui_textview_t* ob = GUI_VP(h);
+    GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
+    return ob->top;
+}
+
+/**
+ * \brief           Get number of indexed lines in virtual mode
+ * \note            Data appended after last redraw are not counted yet
+ * \param[in]       h: Widget handle
+ * \return          Number of lines
+ */
+size_t
+gui_textview_getlinecount(gui_handle_p h) {
+    GUI_ASSERTPARAMS(h != NULL && h->widget == &widget);
+    return index_getlinecount(h);
+}
@@ -44,12 +44,101 @@ typedef struct {
 } gui_widget_default_t;
 gui_widget_default_t widget_default;
 
-/* Widget absolute cache setup */
-#if GUI_CFG_USE_POS_SIZE_CACHE
-#define SET_WIDGET_ABS_VALUES(h)        set_widget_abs_values(h)
-#else
-#define SET_WIDGET_ABS_VALUES(h)
-#endif
+/* Get bucket index in widget ID hash index */
+#define WIDGET_ID_HASH(id)          ((size_t)((id) % GUI_CFG_WIDGET_ID_HASH_SIZE))
+
+/**
+ * \brief           Add widget to ID hash index
+ * \note            Widget is added to the end of bucket to keep creation order for widgets with the same ID
+ * \note            Widgets with ID `0` are not indexed, there are usually many of them (such as keyboard keys)
+ *                  and they would all be placed to the same bucket
+ * \param[in]       h: Widget handle
+ */
+static void
+id_index_add(gui_handle_p h) {
+    gui_handle_p* p;
+    
+    if (h->id == 0) {
+        return;
+    }
+    for (p = &GUI.widget_ids[WIDGET_ID_HASH(h->id)]; *p != NULL; p = &(*p)->id_next) {}
+    h->id_next = NULL;
+    *p = h;
+}
+
+/**
+ * \brief           Remove widget from ID hash index
+ * \param[in]       h: Widget handle
+ */
+static void
+id_index_remove(gui_handle_p h) {
+    gui_handle_p* p;
+    
+    if (h->id == 0) {
+        return;
+    }
+    for (p = &GUI.widget_ids[WIDGET_ID_HASH(h->id)]; *p != NULL; p = &(*p)->id_next) {
+        if (*p == h) {
+            *p = h->id_next;                        /* Skip widget in bucket */
+            h->id_next = NULL;
+            break;
+        }
+    }
+}
+
+/**
+ * \brief           Convert position or size value from public units to widget geometry units
+ * \note            Percent values are clamped to `-GUI_PERCENT_MAX` to `GUI_PERCENT_MAX` range
+ *                  and rounded half away from zero
+ * \param[in]       val: Value in units of pixels or percents
+ * \param[in]       percent: Set to `1` if value is in units of percent
+ * \return          Value in units of pixels or in units of `1 / GUI_PERCENT_SCALE` percent
+ */
+static gui_dim_t
+geometry_from_float(float val, uint8_t percent) {
+    if (percent) {
+        if (val > (float)GUI_PERCENT_MAX) {         /* Clamp to range representable in geometry units */
+            val = (float)GUI_PERCENT_MAX;
+        } else if (val < -(float)GUI_PERCENT_MAX) {
+            val = -(float)GUI_PERCENT_MAX;
+        }
+        val *= (float)GUI_PERCENT_SCALE;
+        val += val < 0 ? -0.5f : 0.5f;              /* Round to nearest */
+    }
+    if (val > (float)GUI_DIM_MAX) {
+        return GUI_DIM_MAX;
+    } else if (val < -(float)GUI_DIM_MAX) {
+        return -GUI_DIM_MAX;
+    }
+    return GUI_DIM(val);
+}
+
+/**
+ * \brief           Convert size value from public units to widget geometry units
+ * \note            Negative sizes are clamped to `0`
+ * \param[in]       val: Value in units of pixels or percents
+ * \param[in]       percent: Set to `1` if value is in units of percent
+ * \return          Value in units of pixels or in units of `1 / GUI_PERCENT_SCALE` percent
+ */
+static gui_dim_t
+size_from_float(float val, uint8_t percent) {
+    gui_dim_t v = geometry_from_float(val, percent);
+    return v < 0 ? 0 : v;
+}
+
+/**
+ * \brief           Convert position or size value from widget geometry units to public units
+ * \param[in]       val: Value in units of pixels or in units of `1 / GUI_PERCENT_SCALE` percent
+ * \param[in]       percent: Set to `1` if value is in units of percent
+ * \return          Value in units of pixels or percents
+ */
+static float
+geometry_to_float(gui_dim_t val, uint8_t percent) {
+    if (percent) {
+        return GUI_FLOAT(val) / (float)GUI_PERCENT_SCALE;
+    }
+    return GUI_FLOAT(val);
+}
 
 /**
  * \brief           Calculate widget absolute width
@@ -63,9 +152,9 @@ calculate_widget_width(gui_handle_p h) {
     if (guii_widget_getflag(h, GUI_FLAG_EXPANDED)) {/* Maximize window over parent */
         width = guii_widget_getparentinnerwidth(h); /* Return parent inner width */
     } else if (guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT)) {   /* Percentage width */
-        width = GUI_DIM(GUI_ROUND((h->width * guii_widget_getparentinnerwidth(h)) / 100.0f));   /* Calculate percent width */
+        width = GUI_DIM_PERCENT(h->width, guii_widget_getparentinnerwidth(h));   /* Calculate percent width */
     } else {                                        /* Normal width */
-        width = GUI_DIM(h->width);                  /* Width in pixels */
+        width = h->width;                           /* Width in pixels */
     }
     return width;
 }
@@ -81,9 +170,9 @@ calculate_widget_height(gui_handle_p h) {
     if (guii_widget_getflag(h, GUI_FLAG_EXPANDED)) {/* Maximize window over parent */
         height = guii_widget_getparentinnerheight(h);   /* Return parent inner height */
     } else if (guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT)) {   /* Percentage width */
-        height = GUI_DIM(GUI_ROUND((h->height * guii_widget_getparentinnerheight(h)) / 100.0f));  /* Calculate percent height */
+        height = GUI_DIM_PERCENT(h->height, guii_widget_getparentinnerheight(h));  /* Calculate percent height */
     } else {                                        /* Normal height */
-        height = GUI_DIM(h->height);                /* Width in pixels */
+        height = h->height;                         /* Height in pixels */
     }
     return height;
 }
@@ -104,10 +193,10 @@ calculate_widget_absolute_x(gui_handle_p h) {
     /* If widget is not expanded, use actual value */
     out = guii_widget_getrelativex(h);              /* Get start relative position */
     
-    /* Process all parent widgets to get real absolute screen value */
-    for (w = guii_widget_getparent(h); w != NULL;
-        w = guii_widget_getparent(w)) {             /* Go through all parent windows */
-        out += guii_widget_getrelativex(w) + gui_widget_getpaddingleft(w);  /* Add X offset from parent and left padding of parent */
+    /* Parent absolute position is already cached, no need to go through all parents */
+    w = guii_widget_getparent(h);
+    if (w != NULL) {
+        out += gui_widget_getabsolutex(w) + gui_widget_getpaddingleft(w);   /* Add X offset from parent and left padding of parent */
         out -= w->x_scroll;                         /* Decrease by scroll value */
     }
     return out;
@@ -129,10 +218,10 @@ calculate_widget_absolute_y(gui_handle_p h) {
     /* If widget is not expanded, use actual value */
     out = guii_widget_getrelativey(h);              /* Get start relative position */
     
-    /* Process all parent widgets to get real absolute screen value */
-    for (w = guii_widget_getparent(h); w != NULL;
-        w = guii_widget_getparent(w)) {             /* Go through all parent windows */
-        out += guii_widget_getrelativey(w) + gui_widget_getpaddingtop(w);   /* Add Y offset from parent and top padding of parent */
+    /* Parent absolute position is already cached, no need to go through all parents */
+    w = guii_widget_getparent(h);
+    if (w != NULL) {
+        out += gui_widget_getabsolutey(w) + gui_widget_getpaddingtop(w);    /* Add Y offset from parent and top padding of parent */
         out -= w->y_scroll;                         /* Decrease by scroll value */
     }
     return out;
@@ -143,71 +232,141 @@ calculate_widget_absolute_y(gui_handle_p h) {
  *                  Actual visible position may change when other widgets cover current one
  *                  which we can take as advantage when drawing widget or when calculating clipping area
  *
+ * \note            Visible area of widget is its own area limited by parent inner area
+ *                  and by parent visible area, which is already cached on parent widget
+ *
  * \param[in]       h: Widget handle
  */
-uint8_t
+static uint8_t
 calculate_widget_absolute_visible_position_size(gui_handle_p h, gui_dim_t* x1, gui_dim_t* y1, gui_dim_t* x2, gui_dim_t* y2) {
-    gui_dim_t x, y, wi, hi, cx, cy, cw, ch;
+    gui_handle_p p;
+    gui_dim_t x, y, wi, hi;
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
-    cx = gui_widget_getabsolutex(h);                /* Get absolute X position */
-    cy = gui_widget_getabsolutey(h);                /* Get absolute Y position */
-    cw = gui_widget_getwidth(h);                    /* Get absolute width */
-    ch = gui_widget_getheight(h);                   /* Get absolute height */
-    
     /* Set widget visible positions with X and Y coordinates */
-    *x1 = cx;
-    *y1 = cy;
-    *x2 = cx + cw;
-    *y2 = cy + ch;
-    
-    /* Check if widget is hidden by any parent or any parent is hidden by its parent */
-    for (; h != NULL; h = guii_widget_getparent(h)) {
-        x = guii_widget_getparentabsolutex(h);      /* Parent absolute X position for inner widgets */
-        y = guii_widget_getparentabsolutey(h);      /* Parent absolute Y position for inner widgets */
-        wi = guii_widget_getparentinnerwidth(h);    /* Get parent inner width */
-        hi = guii_widget_getparentinnerheight(h);   /* Get parent inner height */
-    
-        if (*x1 < x)        { *x1 = x; }
-        if (*x2 > x + wi)   { *x2 = x + wi; }
-        if (*y1 < y)        { *y1 = y; }
-        if (*y2 > y + hi)   { *y2 = y + hi; }
+    *x1 = h->abs_x;
+    *y1 = h->abs_y;
+    *x2 = h->abs_x + h->abs_width;
+    *y2 = h->abs_y + h->abs_height;
+    
+    /* Limit visible area by parent inner area */
+    x = guii_widget_getparentabsolutex(h);          /* Parent absolute X position for inner widgets */
+    y = guii_widget_getparentabsolutey(h);          /* Parent absolute Y position for inner widgets */
+    wi = guii_widget_getparentinnerwidth(h);        /* Get parent inner width */
+    hi = guii_widget_getparentinnerheight(h);       /* Get parent inner height */
+    
+    if (*x1 < x)        { *x1 = x; }
+    if (*x2 > x + wi)   { *x2 = x + wi; }
+    if (*y1 < y)        { *y1 = y; }
+    if (*y2 > y + hi)   { *y2 = y + hi; }
+    
+    /* Limit visible area by visible area of parent, which includes all its parents */
+    p = guii_widget_getparent(h);
+    if (p != NULL) {
+        if (*x1 < p->abs_visible_x1) { *x1 = p->abs_visible_x1; }
+        if (*x2 > p->abs_visible_x2) { *x2 = p->abs_visible_x2; }
+        if (*y1 < p->abs_visible_y1) { *y1 = p->abs_visible_y1; }
+        if (*y2 > p->abs_visible_y2) { *y2 = p->abs_visible_y2; }
     }
     return 1;
 }
 
-#if GUI_CFG_USE_POS_SIZE_CACHE
-
 /**
- * \brief           Set widget absolute values for position and size
+ * \brief           Update widget absolute values for position and size if they are not valid anymore
+ *
+ *                  Only widget itself is recalculated, children widgets are
+ *                  recalculated when their values are requested for the first time.
+ *                  Parent values are updated first (if required) when they are read during calculation.
+ *
  * \param[in]       h: Widget handle
  */
-static uint8_t
-set_widget_abs_values(gui_handle_p h) {
+static void
+update_widget_abs_values(gui_handle_p h) {
+    gui_handle_p p;
+    
+    if (!guii_widget_getflag(h, GUI_FLAG_GEOMETRY_DIRTY)) {
+        return;
+    }
+    
+    /* Make sure parent is up to date before it is used for calculation */
+    p = guii_widget_getparent(h);
+    if (p != NULL) {
+        update_widget_abs_values(p);
+    }
+    
     /* Update widget absolute values */
-    h->abs_x = calculate_widget_absolute_x(h);
-    h->abs_y = calculate_widget_absolute_y(h);
     h->abs_width = calculate_widget_width(h);
     h->abs_height = calculate_widget_height(h);
+    h->abs_x = calculate_widget_absolute_x(h);
+    h->abs_y = calculate_widget_absolute_y(h);
     
     /* Calculate absolute visible position/size on screen */
     calculate_widget_absolute_visible_position_size(h,
         &h->abs_visible_x1, &h->abs_visible_y1,
         &h->abs_visible_x2, &h->abs_visible_y2);
+    
+    guii_widget_clrflag(h, GUI_FLAG_GEOMETRY_DIRTY);/* Values are valid now */
+}
+
+/**
+ * \brief           Mark layout of widget to arrange children again before next redraw
+ * \param[in]       h: Widget handle. Nothing is done if `NULL` or widget has no layout
+ */
+static void
+set_layout_dirty(gui_handle_p h) {
+    if (h != NULL && h->layout != NULL) {
+        guii_widget_setflag(h, GUI_FLAG_LAYOUT_DIRTY);
+        GUI.flags |= GUI_FLAG_LAYOUT_DIRTY;         /* At least one layout must be processed */
+    }
+}
 
-    /* Update children widgets */
+/**
+ * \brief           Mark layouts of children widgets sized relative to widget to arrange them again
+ *
+ *                  Used when size of widget area for children changes. Children with size in percent
+ *                  or in expanded mode get new size, so their own layouts must be processed again.
+ *
+ * \param[in]       h: Widget handle
+ */
+static void
+set_children_layout_dirty(gui_handle_p h) {
+    gui_handle_p child;
+    
     if (guii_widget_haschildren(h)) {
-        gui_handle_p child;
-        
-        /* Scan all children widgets */
         GUI_LINKEDLIST_WIDGETSLISTNEXT(h, child) {
-            set_widget_abs_values(child);           /* Process child widget */
+            if (guii_widget_getflag(child, GUI_FLAG_WIDTH_PERCENT | GUI_FLAG_HEIGHT_PERCENT | GUI_FLAG_EXPANDED)) {
+                set_layout_dirty(child);
+                set_children_layout_dirty(child);   /* Its children are resized too */
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Mark widget absolute values for position and size as invalid
+ *
+ *                  Children widgets are marked too as their absolute values depend on parent.
+ *                  When widget is already marked, all its children are marked too, so scan stops there.
+ *
+ * \param[in]       h: Widget handle
+ */
+static void
+set_widget_geometry_dirty(gui_handle_p h) {
+    gui_handle_p child;
+    
+    if (guii_widget_getflag(h, GUI_FLAG_GEOMETRY_DIRTY)) {
+        return;                                     /* Widget and its children are already marked */
+    }
+    guii_widget_setflag(h, GUI_FLAG_GEOMETRY_DIRTY);
+    
+    /* Mark children widgets */
+    if (guii_widget_haschildren(h)) {
+        GUI_LINKEDLIST_WIDGETSLISTNEXT(h, child) {
+            set_widget_geometry_dirty(child);       /* Process child widget */
         }
     }
-    return 1;
 }
-#endif /* GUI_CFG_USE_POS_SIZE_CACHE */
 
 /**
  * \brief           Remove widget from memory
@@ -254,7 +413,8 @@ remove_widget(gui_handle_p h) {
      *      make sure parent is redrawn on screen
      * - Free any possible memory used for text operation
      * - Remove software timer if exists
-     * - Remove custom colors
+     * - Stop running animations of widget
+     * - Release style reference
      * - Remove widget from its linkedlist
      * - Free widget memory
      */
@@ -263,12 +423,19 @@ remove_widget(gui_handle_p h) {
     if (h->timer != NULL) {
         guii_timer_remove(&h->timer);
     }
-    if (h->colors != NULL) {
-        GUI_MEMFREE(h->colors);
-        h->colors = NULL;
+    guii_anim_stopwidget(h);
+    if (h->style != NULL) {
+        h->style->users--;
+        gui_style_release(h->style);
+        h->style = NULL;
     }
+    if (guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)) {
+        GUI.update_pending--;                       /* Widget is not processed at the end of update transaction */
+    }
+    set_layout_dirty(guii_widget_getparent(h));     /* Arrange remaining siblings */
     gui_linkedlist_widgetremove(h);                 /* Remove entry from linked list of parent widget */
-    GUI_MEMFREE(h);                                 /* Free memory for widget */
+    id_index_remove(h);                             /* Remove entry from ID index */
+    gui_mem_pool_free(h, h->widget->size);          /* Free memory for widget */
     
     return 1;                                       /* Widget deleted */
 }
@@ -348,17 +515,14 @@ remove_widgets(gui_handle_p parent) {
  * \param[out]      y2: Output variable to save bottom right Y position on screen
  * \return          `1` on success, `0` otherwise
  */
-static uint8_t
-get_widget_abs_visible_position_size(gui_handle_p h, gui_dim_t* x1, gui_dim_t* y1, gui_dim_t* x2, gui_dim_t* y2) {
-#if GUI_CFG_USE_POS_SIZE_CACHE
+uint8_t
+guii_widget_getabsvisibleposition(gui_handle_p h, gui_dim_t* x1, gui_dim_t* y1, gui_dim_t* x2, gui_dim_t* y2) {
+    update_widget_abs_values(h);                    /* Make sure cached values are valid */
     *x1 = h->abs_visible_x1;
     *y1 = h->abs_visible_y1;
     *x2 = h->abs_visible_x2;
     *y2 = h->abs_visible_y2;
     return 1;
-#else /* GUI_CFG_USE_POS_SIZE_CACHE */
-    return calculate_widget_absolute_visible_position_size(h, x1, y1, x2, y2);
-#endif /* !GUI_CFG_USE_POS_SIZE_CACHE */
 }
 
 /**
@@ -373,7 +537,7 @@ set_clipping_region(gui_handle_p h) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
     /* Get visible widget part and absolute position on screen according to parent */
-    get_widget_abs_visible_position_size(h, &x1, &y1, &x2, &y2);
+    guii_widget_getabsvisibleposition(h, &x1, &y1, &x2, &y2);
     
     /* Possible improvement */
     /*
@@ -393,6 +557,22 @@ set_clipping_region(gui_handle_p h) {
     return 1;
 }
 
+/**
+ * \brief           Check if widget is linked to list of its parent widget
+ * \param[in]       h: Widget handle
+ * \return          `1` if linked, `0` otherwise
+ */
+static uint8_t
+is_widget_linked(gui_handle_p h) {
+    gui_linkedlistroot_t* root;
+    
+    root = guii_widget_hasparent(h) ? &guii_widget_getparent(h)->root_list : &GUI.root;
+    return h->list.prev != NULL || root->first == (void *)h;
+}
+
+/* Number of redrawn sibling areas tracked separately on overlap check, bounding box is used after */
+#define INVALIDATE_AREAS_MAX            8
+
 /**
  * \brief           Invalidate widget and set redraw flag
  * \note            If widget is transparent, parent must be updated too. This function will handle these cases.
@@ -402,9 +582,10 @@ set_clipping_region(gui_handle_p h) {
  */
 static uint8_t
 invalidate_widget(gui_handle_p h, uint8_t setclipping) {
-    gui_handle_p h1, h2;
-    gui_dim_t h1x1, h1x2, h2x1, h2x2;
-    gui_dim_t h1y1, h1y2, h2y1, h2y2;
+    gui_handle_p h1;
+    gui_display_t areas[INVALIDATE_AREAS_MAX], box;
+    gui_dim_t x1, y1, x2, y2;
+    size_t areas_cnt = 0, i;
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
@@ -413,24 +594,32 @@ invalidate_widget(gui_handle_p h, uint8_t setclipping) {
         return 0;
     }
 
+    /* First check if any of parent widgets are hidden = ignore redraw */
+    for (h1 = guii_widget_getparent(h); h1 != NULL;
+        h1 = guii_widget_getparent(h1)) {
+        if (guii_widget_ishidden(h1)) {
+            return 1;
+        }
+    }
+    guii_widget_clrflag(h, GUI_FLAG_FIRST_INVALIDATE);  /* Clear flag */
+    
     /*
-     * First check if any of parent widgets are hidden = ignore redraw
+     * Inside update transaction, only mark widget as pending.
+     * Clipping region, redraw flags and overlapping widgets are processed once at the end of transaction,
+     * when final widget area is known.
      *
-     * When widget is invalidated for first first time,
-     * ignore this check and force widget invalidation to create absolute visible positions for later usage
+     * Widget not linked to parent list cannot be found at the end of transaction and is processed immediately
      */
-#if GUI_CFG_USE_POS_SIZE_CACHE
-    if (!guii_widget_getflag(h, GUI_FLAG_FIRST_INVALIDATE)) 
-#endif /* GUI_CFG_USE_POS_SIZE_CACHE */
-    {
-        for (h1 = guii_widget_getparent(h); h1 != NULL;
-            h1 = guii_widget_getparent(h1)) {
-            if (guii_widget_ishidden(h1)) {
-                return 1;
-            }
+    if (GUI.update_level > 0 && is_widget_linked(h)) {
+        if (setclipping) {
+            guii_widget_setflag(h, GUI_FLAG_INVALIDATE_CLIPPING);
+        }
+        if (!guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)) {
+            guii_widget_setflag(h, GUI_FLAG_INVALIDATE_PENDING);
+            GUI.update_pending++;
         }
+        return 1;
     }
-    guii_widget_clrflag(h, GUI_FLAG_FIRST_INVALIDATE);  /* Clear flag */
         
     h1 = h;                                         /* Save temporary */
     guii_widget_setflag(h1, GUI_FLAG_REDRAW);       /* Redraw widget */
@@ -447,6 +636,10 @@ invalidate_widget(gui_handle_p h, uint8_t setclipping) {
      *
      * Widget may not need redraw operation if positions don't match
      *
+     * Siblings are scanned only once in z-order. Areas of widgets already marked for redraw are collected
+     * and every next sibling is checked against them, first against their bounding box and later one by one.
+     * When there are too many areas, bounding box only is used which may redraw more widgets than necessary.
+     *
      * If widget is transparent, check all widgets, even those which are below current widget in list
      * Get first element of parent linked list for checking
      */
@@ -455,26 +648,45 @@ invalidate_widget(gui_handle_p h, uint8_t setclipping) {
         invalidate_widget(guii_widget_getparent(h1), 0);    /* Invalidate parent widget */
     }
 #endif /* GUI_CFG_USE_ALPHA */
-    for (; h1 != NULL; h1 = gui_linkedlist_widgetgetnext(NULL, h1)) {
-        get_widget_abs_visible_position_size(h1, &h1x1, &h1y1, &h1x2, &h1y2); /* Get visible position on LCD for widget */
+    guii_widget_getabsvisibleposition(h1, &box.x1, &box.y1, &box.x2, &box.y2);
+    areas[areas_cnt++] = box;
+    for (h1 = gui_linkedlist_widgetgetnext(NULL, h1); h1 != NULL;
+            h1 = gui_linkedlist_widgetgetnext(NULL, h1)) {
+        /* Get visible position on LCD for widget */
+        guii_widget_getabsvisibleposition(h1, &x1, &y1, &x2, &y2);
         
-        /* Scan widgets on top of current widget */
-        for (h2 = gui_linkedlist_widgetgetnext(NULL, h1); h2 != NULL;
-                h2 = gui_linkedlist_widgetgetnext(NULL, h2)) {
-            /* Get visible position on second widget */
-            get_widget_abs_visible_position_size(h2, &h2x1, &h2y1, &h2x2, &h2y2);
-                    
-            /* Check if next widget is on top of current one */
-            if (
-                guii_widget_getflag(h2, GUI_FLAG_REDRAW) || /* Flag is already set */
-                !GUI_RECT_MATCH(                    /* Widgets are not one over another */
-                    h1x1, h1y1, h1x2, h1y2,
-                    h2x1, h2y1, h2x2, h2y2)
-            ) {
+        /* Check if widget is on top of any widget marked for redraw */
+        if (!guii_widget_getflag(h1, GUI_FLAG_REDRAW)) {
+            if (!GUI_RECT_MATCH(x1, y1, x2, y2, box.x1, box.y1, box.x2, box.y2)) {
                 continue;
             }
-            guii_widget_setflag(h2, GUI_FLAG_REDRAW);   /* Redraw widget on next loop */
+            if (areas_cnt <= INVALIDATE_AREAS_MAX) {/* Check areas one by one when all are known */
+                for (i = 0; i < areas_cnt; i++) {
+                    if (GUI_RECT_MATCH(x1, y1, x2, y2, areas[i].x1, areas[i].y1, areas[i].x2, areas[i].y2)) {
+                        break;
+                    }
+                }
+                if (i == areas_cnt) {
+                    continue;
+                }
+            }
+            guii_widget_setflag(h1, GUI_FLAG_REDRAW);   /* Redraw widget on next loop */
+        }
+        
+        /* Widget is redrawn, add its area */
+        if (areas_cnt < INVALIDATE_AREAS_MAX) {
+            areas[areas_cnt].x1 = x1;
+            areas[areas_cnt].y1 = y1;
+            areas[areas_cnt].x2 = x2;
+            areas[areas_cnt].y2 = y2;
         }
+        if (areas_cnt <= INVALIDATE_AREAS_MAX) {
+            areas_cnt++;                            /* Value above maximum means bounding box only */
+        }
+        box.x1 = GUI_MIN(box.x1, x1);
+        box.y1 = GUI_MIN(box.y1, y1);
+        box.x2 = GUI_MAX(box.x2, x2);
+        box.y2 = GUI_MAX(box.y2, y2);
     }
     
     /*
@@ -506,8 +718,37 @@ invalidate_widget(gui_handle_p h, uint8_t setclipping) {
     return 1;
 }
 
+/**
+ * \brief           Process invalidation of widgets deferred by update transaction
+ * \param[in]       parent: Parent widget handle. Set to `NULL` to use root
+ */
+static void
+process_pending_invalidations(gui_handle_p parent) {
+    gui_handle_p h;
+    
+    GUI_LINKEDLIST_WIDGETSLISTNEXT(parent, h) {
+        if (!GUI.update_pending) {                  /* Stop when all widgets are processed */
+            return;
+        }
+        if (guii_widget_getflag(h, GUI_FLAG_INVALIDATE_PENDING)) {
+            guii_widget_clrflag(h, GUI_FLAG_INVALIDATE_PENDING);
+            GUI.update_pending--;
+            invalidate_widget(h, !!guii_widget_getflag(h, GUI_FLAG_INVALIDATE_CLIPPING));   /* Clipping region from final area */
+            guii_widget_clrflag(h, GUI_FLAG_INVALIDATE_CLIPPING);
+        }
+        if (guii_widget_haschildren(h)) {
+            process_pending_invalidations(h);       /* Process children widgets */
+        }
+    }
+}
+
 /**
  * \brief           Get widget by specific input parameters
+ *
+ *                  Search is done on ID hash index and does not depend on number of widgets in tree.
+ *                  If multiple widgets with the same ID match, widget created first is returned.
+ *                  Widgets with ID `0` are not indexed and are never found
+ *
  * \param[in]       parent: Parent widget handle. Set to NULL to use root
  * \param[in]       id: Widget id we are searching for in parent
  * \param[in]       deep: Flag if search should go deeper to check for widget on parent tree
@@ -515,16 +756,23 @@ invalidate_widget(gui_handle_p h, uint8_t setclipping) {
  */
 static gui_handle_p
 get_widget_by_id(gui_handle_p parent, gui_id_t id, uint8_t deep) {
-    gui_handle_p h;
+    gui_handle_p h, p;
     
-    /* List all widgets of parent*/
-    GUI_LINKEDLIST_WIDGETSLISTNEXT(parent, h) {
-        if (gui_widget_getid(h) == id) {
+    for (h = GUI.widget_ids[WIDGET_ID_HASH(id)]; h != NULL; h = h->id_next) {
+        if (h->id != id) {
+            continue;
+        }
+        if (!deep) {                                /* Only direct children of parent */
+            if (guii_widget_getparent(h) == parent) {
+                return h;
+            }
+        } else if (parent == NULL) {                /* Any widget in tree */
             return h;
-        } else if (deep && guii_widget_haschildren(h)) {    /* Check children if possible */
-            gui_handle_p tmp = get_widget_by_id(h, id, deep);
-            if (tmp != NULL) {
-                return tmp;
+        } else {
+            for (p = guii_widget_getparent(h); p != NULL; p = guii_widget_getparent(p)) {
+                if (p == parent) {                  /* Widget is on parent tree */
+                    return h;
+                }
             }
         }
     }
@@ -564,7 +812,7 @@ get_common_parentwidget(gui_handle_p h1, gui_handle_p h2) {
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-set_widget_size(gui_handle_p h, float wi, float hi, uint8_t wp, uint8_t hp) {
+set_widget_size(gui_handle_p h, gui_dim_t wi, gui_dim_t hi, uint8_t wp, uint8_t hp) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
     if ( wi != h->width || hi != h->height ||       /* Check any differences */
@@ -582,6 +830,9 @@ set_widget_size(gui_handle_p h, float wi, float hi, uint8_t wp, uint8_t hp) {
         
         /* First invalidate current position if not expanded before change of size */
         if (!gui_widget_isexpanded(h) && !guii_widget_getflag(h, GUI_FLAG_FIRST_INVALIDATE)) {
+            if (GUI.update_level > 0) {
+                set_clipping_region(h);             /* Old area is not known at the end of transaction */
+            }
             gui_widget_invalidatewithparent(h);     /* Set old clipping region first */
         }
         
@@ -604,7 +855,10 @@ set_widget_size(gui_handle_p h, float wi, float hi, uint8_t wp, uint8_t hp) {
         /* Set values for width and height */
         h->width = wi;                              /* Set parameter */
         h->height = hi;                             /* Set parameter */
-        SET_WIDGET_ABS_VALUES(h);                   /* Set widget absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate widget absolute values */
+        set_layout_dirty(h);                        /* Arrange children for new size */
+        set_children_layout_dirty(h);               /* Children in percents are resized too */
+        set_layout_dirty(guii_widget_getparent(h)); /* Arrange widget and its siblings */
         
         /* Check if any of dimensions are bigger than before */
         if (!gui_widget_isexpanded(h) && !guii_widget_getflag(h, GUI_FLAG_FIRST_INVALIDATE) &&
@@ -629,7 +883,7 @@ set_widget_size(gui_handle_p h, float wi, float hi, uint8_t wp, uint8_t hp) {
  * \return          `1` on success, `0` otherwise
  */
 static uint8_t
-set_widget_position(gui_handle_p h, float x, float y, uint8_t xp, uint8_t yp) {
+set_widget_position(gui_handle_p h, gui_dim_t x, gui_dim_t y, uint8_t xp, uint8_t yp) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
     if (h->x != x || h->y != y ||                   /* Check any differences */
@@ -645,6 +899,9 @@ set_widget_position(gui_handle_p h, float x, float y, uint8_t xp, uint8_t yp) {
         guii_widget_clrflag(h, GUI_FLAG_IGNORE_INVALIDATE); /* Clear flag */
 
         if (!gui_widget_isexpanded(h) && !guii_widget_getflag(h, GUI_FLAG_FIRST_INVALIDATE)) {
+            if (GUI.update_level > 0) {
+                set_clipping_region(h);             /* Old area is not known at the end of transaction */
+            }
             gui_widget_invalidatewithparent(h);     /* Set old clipping region first */
         }
         
@@ -663,7 +920,7 @@ set_widget_position(gui_handle_p h, float x, float y, uint8_t xp, uint8_t yp) {
         /* Set new position coordinates */
         h->x = x;                                   /* Set parameter */
         h->y = y;                                   /* Set parameter */
-        SET_WIDGET_ABS_VALUES(h);                   /* Set widget absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate widget absolute values */
         
         if (!gui_widget_isexpanded(h) && !guii_widget_getflag(h, GUI_FLAG_FIRST_INVALIDATE)) {
             gui_widget_invalidatewithparent(h);     /* Set new clipping region */
@@ -723,7 +980,7 @@ guii_widget_isinsideclippingregion(gui_handle_p h, uint8_t check_sib_cover) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
     /* Get widget visible section */
-    get_widget_abs_visible_position_size(h, &x1, &y1, &x2, &y2);
+    guii_widget_getabsvisibleposition(h, &x1, &y1, &x2, &y2);
 
     /* Check if widget is inside drawing area */
     if (!GUI_RECT_MATCH(
@@ -751,7 +1008,7 @@ guii_widget_isinsideclippingregion(gui_handle_p h, uint8_t check_sib_cover) {
             }
 
             /* Get display information for new widget */
-            get_widget_abs_visible_position_size(tmp, &tx1, &ty1, &tx2, &ty2);
+            guii_widget_getabsvisibleposition(tmp, &tx1, &ty1, &tx2, &ty2);
 
             /* Check if widget is inside */
             if (GUI_RECT_IS_INSIDE(x1, y1, x2, y2, tx1, ty1, tx2, ty2) &&
@@ -774,6 +1031,196 @@ guii_widget_init(void) {
     gui_window_createdesktop(GUI_ID_WINDOW_BASE, NULL);     /* Create base window object */
 }
 
+/**
+ * \brief           Set geometry of child widget arranged by layout
+ * \param[in]       h: Child widget handle
+ * \param[in]       x: X position in units of pixels
+ * \param[in]       y: Y position in units of pixels
+ * \param[in]       width: Width in units of pixels or `-1` to keep current width
+ * \param[in]       height: Height in units of pixels or `-1` to keep current height
+ */
+static void
+place_layout_child(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    uint8_t resized = 0;
+    
+    h->x = x;
+    h->y = y;
+    guii_widget_clrflag(h, GUI_FLAG_XPOS_PERCENT | GUI_FLAG_YPOS_PERCENT);
+    if (width >= 0 && (h->width != width || guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT))) {
+        h->width = width;
+        guii_widget_clrflag(h, GUI_FLAG_WIDTH_PERCENT);
+        resized = 1;
+    }
+    if (height >= 0 && (h->height != height || guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT))) {
+        h->height = height;
+        guii_widget_clrflag(h, GUI_FLAG_HEIGHT_PERCENT);
+        resized = 1;
+    }
+    set_widget_geometry_dirty(h);
+    if (resized) {
+        set_layout_dirty(h);                        /* Nested layout is processed in the same pass */
+        set_children_layout_dirty(h);
+    }
+}
+
+/**
+ * \brief           Arrange children widgets according to widget layout
+ *
+ *                  Geometry of all children is calculated in single pass over children list,
+ *                  widget is invalidated once at the end
+ *
+ * \param[in]       h: Widget handle with layout
+ */
+static void
+arrange_layout(gui_handle_p h) {
+    const gui_layout_t* l = h->layout;
+    gui_handle_p c;
+    gui_dim_t iw, ih, sp, pos, size, fixed = 0, line = 0, cw = 0, ch = 0, x = 0, y = 0;
+    uint32_t weights = 0, acc = 0;
+    size_t count = 0;
+    uint8_t col = 0, span, cols, row = l->type == GUI_LAYOUT_ROW;
+    
+    guii_widget_clrflag(h, GUI_FLAG_LAYOUT_DIRTY);
+    iw = gui_widget_getinnerwidth(h);
+    ih = gui_widget_getinnerheight(h);
+    sp = l->spacing;
+    
+    switch (l->type) {
+        case GUI_LAYOUT_ROW:
+        case GUI_LAYOUT_COLUMN: {
+            /* Measure fixed size and weights of visible children */
+            GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+                if (guii_widget_getflag(c, GUI_FLAG_HIDDEN)) {
+                    continue;
+                }
+                if (c->layout_weight) {
+                    weights += c->layout_weight;
+                } else {
+                    fixed += row ? gui_widget_getwidth(c) : gui_widget_getheight(c);
+                }
+                count++;
+            }
+            
+            /* Share free space by weights, rounding errors go to last weighted child */
+            size = (row ? iw : ih) - fixed - (count ? sp * GUI_DIM(count - 1) : 0);
+            if (size < 0) {
+                size = 0;
+            }
+            pos = 0;
+            GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+                gui_dim_t s;
+                
+                if (guii_widget_getflag(c, GUI_FLAG_HIDDEN)) {
+                    continue;
+                }
+                if (c->layout_weight) {
+                    s = GUI_DIM((size * (acc + c->layout_weight)) / weights - (size * acc) / weights);
+                    acc += c->layout_weight;
+                } else {
+                    s = row ? gui_widget_getwidth(c) : gui_widget_getheight(c);
+                }
+                if (row) {
+                    place_layout_child(c, pos, 0, c->layout_weight ? s : -1, ih);
+                } else {
+                    place_layout_child(c, 0, pos, iw, c->layout_weight ? s : -1);
+                }
+                pos += s + sp;
+            }
+            pos = count ? pos - sp : 0;
+            cw = row ? pos : iw;
+            ch = row ? ih : pos;
+            break;
+        }
+        case GUI_LAYOUT_WRAP: {
+            GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+                gui_dim_t w, hh;
+                
+                if (guii_widget_getflag(c, GUI_FLAG_HIDDEN)) {
+                    continue;
+                }
+                w = gui_widget_getwidth(c);
+                hh = gui_widget_getheight(c);
+                if (x > 0 && x + w > iw) {          /* Wrap to new row */
+                    x = 0;
+                    y += line + sp;
+                    line = 0;
+                }
+                place_layout_child(c, x, y, -1, -1);
+                x += w;
+                cw = GUI_MAX(cw, x);
+                x += sp;
+                line = GUI_MAX(line, hh);
+            }
+            ch = y + line;
+            break;
+        }
+        case GUI_LAYOUT_GRID: {
+            cols = l->columns ? l->columns : 1;
+            size = (iw - sp * GUI_DIM(cols - 1)) / GUI_DIM(cols);   /* Width of single cell */
+            if (size < 0) {
+                size = 0;
+            }
+            GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+                if (guii_widget_getflag(c, GUI_FLAG_HIDDEN)) {
+                    continue;
+                }
+                span = c->layout_weight ? GUI_MIN(c->layout_weight, cols) : 1;
+                if (col + span > cols) {            /* Continue in new row */
+                    col = 0;
+                    y += line + sp;
+                    line = 0;
+                }
+                x = GUI_DIM(col) * (size + sp);
+                place_layout_child(c, x, y, size * GUI_DIM(span) + sp * GUI_DIM(span - 1), -1);
+                cw = GUI_MAX(cw, x + c->width);
+                line = GUI_MAX(line, gui_widget_getheight(c));
+                col += span;
+            }
+            ch = y + line;
+            break;
+        }
+        default:
+            break;
+    }
+    
+    h->layout_width = cw;                           /* Save size of content for scrolling */
+    h->layout_height = ch;
+    gui_widget_invalidate(h);                       /* Redraw widget with all children once */
+}
+
+/**
+ * \brief           Process layouts marked for new arrange in widget tree
+ * \param[in]       parent: Parent widget handle. Set to `NULL` to use root
+ */
+static void
+process_layouts(gui_handle_p parent) {
+    gui_handle_p h;
+    
+    GUI_LINKEDLIST_WIDGETSLISTNEXT(parent, h) {
+        if (guii_widget_getflag(h, GUI_FLAG_LAYOUT_DIRTY)) {
+            arrange_layout(h);                      /* Arrange before children, nested layouts depend on it */
+        }
+        if (guii_widget_haschildren(h)) {
+            process_layouts(h);
+        }
+    }
+}
+
+/**
+ * \brief           Arrange children of all widgets with modified layout
+ * \note            Called once before redraw, all layout changes until then are processed together
+ * \return          `1` if any layout was processed, `0` otherwise
+ */
+uint8_t
+guii_widget_executelayout(void) {
+    if (GUI.flags & GUI_FLAG_LAYOUT_DIRTY) {        /* Anything to arrange? */
+        process_layouts(NULL);
+        GUI.flags &= ~GUI_FLAG_LAYOUT_DIRTY;
+        return 1;
+    }
+    return 0;
+}
+
 /**
  * \brief           Execute remove, check all widgets with remove status
  * \return          `1` on success, `0` otherwise
@@ -799,7 +1246,9 @@ guii_widget_movedowntree(gui_handle_p h) {
      * This will allow widget to be first checked next time for touch detection
      * and will be drawn on top of al widgets as expected except if there is widget which allows children (new window or similar)
      */
-    if (gui_linkedlist_widgetmovetobottom(h)) {
+    if (guii_widget_hasparent(h) && guii_widget_getparent(h)->layout != NULL) {
+        /* Order of children defines their place in layout and must not change */
+    } else if (gui_linkedlist_widgetmovetobottom(h)) {
         gui_widget_invalidate(h);                   /* Invalidate object */
     }
     
@@ -972,11 +1421,8 @@ gui_widget_getabsolutex(gui_handle_p h) {
     if (h == NULL) {                                /* Check input value */
         return 0;                                   /* At left value */
     }
-#if GUI_CFG_USE_POS_SIZE_CACHE
+    update_widget_abs_values(h);                    /* Make sure cached values are valid */
     return h->abs_x;                                /* Cached value */
-#else /* GUI_CFG_USE_POS_SIZE_CACHE */
-    return calculate_widget_absolute_x(h);          /* Calculate value */
-#endif /* !GUI_CFG_USE_POS_SIZE_CACHE */
 }
 
 /**
@@ -989,11 +1435,8 @@ gui_widget_getabsolutey(gui_handle_p h) {
     if (h == NULL) {                                /* Check input value */
         return 0;                                   /* At left value */
     }
-#if GUI_CFG_USE_POS_SIZE_CACHE
+    update_widget_abs_values(h);                    /* Make sure cached values are valid */
     return h->abs_y;                                /* Cached value */
-#else /* GUI_CFG_USE_POS_SIZE_CACHE */
-    return calculate_widget_absolute_y(h);          /* Calculate value */
-#endif /* !GUI_CFG_USE_POS_SIZE_CACHE */
 }
 
 /**
@@ -1114,15 +1557,17 @@ gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, flo
         return 0;
     }
 
-    h = GUI_MEMALLOC(widget->size);                 /* Allocate memory for widget */
+    h = gui_mem_pool_alloc(widget->size);           /* Allocate memory for widget from pool of widget size */
     if (h != NULL) {
         gui_evt_param_t param = {0};
         gui_evt_result_t result = {0};
+        uint8_t is_flag;
 
         h->id = id;                                 /* Save ID */
         h->widget = widget;                         /* Widget object structure */
         h->footprint = GUI_WIDGET_FOOTPRINT;        /* Set widget footprint */
         h->callback = evt_fn;                       /* Set widget callback */
+        guii_widget_setflag(h, GUI_FLAG_GEOMETRY_DIRTY);    /* Absolute values are not calculated yet */
 #if GUI_CFG_USE_ALPHA
         h->alpha = 0xFF;                            /* Set full transparency by default */
 #endif /* GUI_CFG_USE_ALPHA */
@@ -1151,7 +1596,7 @@ gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, flo
         guii_widget_callback(h, GUI_EVT_PRE_INIT, NULL, &result);    /* Notify internal widget library about init successful */
         
         if (!GUI_EVT_RESULTTYPE_U8(&result)) {
-            GUI_MEMFREE(h);
+            gui_mem_pool_free(h, widget->size);
             h = NULL;
         }
         
@@ -1163,7 +1608,6 @@ gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, flo
             guii_widget_setflag(h, GUI_FLAG_FIRST_INVALIDATE);  /* Ignore invalidation process for size and position */
             gui_widget_setsize(h, GUI_DIM(width), GUI_DIM(height)); /* Set widget size */
             gui_widget_setposition(h, GUI_DIM(x), GUI_DIM(y));  /* Set widget position */
-            gui_widget_invalidate(h);               /* Force invalidation once we set size and position first time */
             
 #if GUI_CFG_WIDGET_CREATE_IGNORE_INVALIDATE
             flags |= GUI_FLAG_WIDGET_CREATE_IGNORE_INVALIDATE;  /* Add ignore invalidate flag */
@@ -1178,9 +1622,18 @@ gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, flo
             guii_widget_callback(h, GUI_EVT_EXCLUDELINKEDLIST, NULL, &result);
             if (!GUI_EVT_RESULTTYPE_U8(&result)) {   /* Check if widget should be added to linked list */
                 gui_linkedlist_widgetadd(h->parent, h); /* Add entry to linkedlist of parent widget */
+                id_index_add(h);                    /* Add entry to ID index */
+                set_layout_dirty(h->parent);        /* Place new widget in parent layout */
             }
             guii_widget_callback(h, GUI_EVT_INIT, NULL, NULL);  /* Notify user about init successful */
+            
+            /* Force invalidation once widget is linked, inside update transaction it is processed with final area */
+            is_flag = !!guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE);
+            guii_widget_clrflag(h, GUI_FLAG_IGNORE_INVALIDATE);
             gui_widget_invalidate(h);               /* Invalidate object */
+            if (is_flag) {
+                guii_widget_setflag(h, GUI_FLAG_IGNORE_INVALIDATE);
+            }
 
             /* Notify parent widget if exists */
             if (guii_widget_hasparent(h)) {         /* If widget has parent */
@@ -1197,8 +1650,337 @@ gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, flo
 /**                  .....                **/
 /*******************************************/
 
+/**
+ * \brief           Allocate new style object with reference count set to `1`
+ * \param[in]       color_count: Number of colors allocated together with style.
+ *                      Use `0` when style uses external colors array
+ * \return          Pointer to new style on success, `NULL` otherwise
+ */
+static gui_style_p
+alloc_style(uint8_t color_count) {
+    gui_style_p style;
+    
+    style = GUI_MEMALLOC_TAG(sizeof(*style) + sizeof(gui_color_t) * color_count, GUI_MEM_TAG_WIDGET);
+    if (style != NULL) {
+        style->ref = 1;
+        if (color_count) {                          /* Colors are placed right after style structure */
+            style->colors = (const gui_color_t *)(style + 1);
+            style->color_count = color_count;
+            style->flags = GUI_STYLE_FLAG_COLORS_ALLOC;
+        }
+    }
+    return style;
+}
+
+/**
+ * \brief           Set font to widget and rebuild everything depending on it
+ * \param[in]       h: Widget handle
+ * \param[in]       font: Pointer to \ref gui_font_t object for font
+ */
+static void
+set_widget_font(gui_handle_p h, const gui_font_t* font) {
+    h->font = font;
+    guii_widget_setflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Text layout depends on font */
+    set_layout_dirty(h);
+    gui_widget_invalidatewithparent(h);
+}
+
+/**
+ * \brief           Get private style of widget before its value is modified (copy on write)
+ *
+ *                  When style is shared with other widgets, widget gets its own copy of it first,
+ *                  so modification does not affect other widgets and is not overwritten
+ *                  when shared style is modified later
+ *
+ * \param[in]       h: Widget handle with style set
+ * \param[in]       colors: Set to `1` when colors of style will be modified
+ * \return          Pointer to private style on success, `NULL` otherwise
+ */
+static gui_style_p
+detach_style(gui_handle_p h, uint8_t colors) {
+    gui_style_p style = h->style;
+    uint8_t i;
+    
+    if (style != NULL && style->ref == 1 && (!colors || ((style->flags & GUI_STYLE_FLAG_COLORS_ALLOC)
+        && style->color_count >= h->widget->color_count))) {
+        return style;                               /* Style is already private */
+    }
+    
+    /* Colors allocated with shared style must be copied, external colors array is used directly */
+    if (colors || (style != NULL && style->flags & GUI_STYLE_FLAG_COLORS_ALLOC)) {
+        style = alloc_style(h->widget->color_count);
+        if (style == NULL) {
+            return NULL;
+        }
+        for (i = 0; i < h->widget->color_count; i++) {  /* Copy all current colors first */
+            ((gui_color_t *)style->colors)[i] = guii_widget_getcolor(h, i);
+        }
+    } else {
+        style = alloc_style(0);
+        if (style == NULL) {
+            return NULL;
+        }
+        if (h->style != NULL) {
+            style->colors = h->style->colors;
+            style->color_count = h->style->color_count;
+        }
+    }
+    if (h->style != NULL) {
+        style->font = h->style->font;
+        style->padding = h->style->padding;
+        style->flags |= h->style->flags & ~GUI_STYLE_FLAG_COLORS_ALLOC;
+        h->style->users--;
+        gui_style_release(h->style);
+    }
+    style->users = 1;
+    h->style = style;
+    return style;
+}
+
+/**
+ * \brief           Apply style font, padding and 3D mode to widget
+ * \param[in]       h: Widget handle with style set
+ */
+static void
+apply_style(gui_handle_p h) {
+    gui_style_p style = h->style;
+    
+    if (style == NULL) {
+        return;
+    }
+    if (style->font != NULL && h->font != style->font) {
+        set_widget_font(h, style->font);
+    }
+    if (style->flags & GUI_STYLE_FLAG_PADDING && h->padding != style->padding) {
+        h->padding = style->padding;
+        set_widget_geometry_dirty(h);
+        set_layout_dirty(h);
+        set_children_layout_dirty(h);
+    }
+    if (style->flags & GUI_STYLE_FLAG_3D_SET) {
+        if (style->flags & GUI_STYLE_FLAG_3D) {
+            guii_widget_setflag(h, GUI_FLAG_3D);
+        } else {
+            guii_widget_clrflag(h, GUI_FLAG_3D);
+        }
+    }
+}
+
+/**
+ * \brief           Apply style again to all widgets using it
+ * \param[in]       parent: Parent widget of tree to scan. Set to `NULL` to start at root
+ * \param[in]       style: Modified style
+ * \param[in,out]   left: Number of widgets using style not found yet, scan stops when it reaches `0`
+ */
+static void
+update_style_widgets(gui_handle_p parent, gui_style_p style, size_t* left) {
+    gui_handle_p h;
+    
+    GUI_LINKEDLIST_WIDGETSLISTNEXT(parent, h) {
+        if (h->style == style) {
+            apply_style(h);
+            gui_widget_invalidate(h);
+            if (--*left == 0) {                     /* All widgets using style were updated */
+                return;
+            }
+        }
+        if (guii_widget_haschildren(h)) {
+            update_style_widgets(h, style, left);   /* Scan children widgets */
+            if (*left == 0) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Refresh all widgets after shared style was modified
+ *
+ *                  Invalidations are collected in single update transaction,
+ *                  so every affected area is redrawn only once
+ *
+ * \param[in]       style: Modified style
+ */
+static void
+refresh_style(gui_style_p style) {
+    size_t left = style->users;
+    
+    if (!left) {                                    /* No widget uses style yet */
+        return;
+    }
+    gui_widget_update_begin();
+    update_style_widgets(NULL, style, &left);
+    gui_widget_update_end();
+}
+
+/**
+ * \brief           Create new shared style
+ *
+ *                  Style is reference counted. Reference returned by this function
+ *                  belongs to caller and must be released with \ref gui_style_release
+ *                  when not used anymore. Every widget using style holds its own reference.
+ *
+ * \note            Colors array is not copied and must stay valid while style is in use (it may be placed in ROM)
+ * \param[in]       colors: Pointer to colors in the same order as widget colors or `NULL` to use widget defaults
+ * \param[in]       color_count: Number of colors in array
+ * \return          Pointer to new style on success, `NULL` otherwise
+ * \sa              gui_widget_setstyle
+ */
+gui_style_p
+gui_style_create(const gui_color_t* colors, uint8_t color_count) {
+    gui_style_p style;
+    
+    style = alloc_style(0);
+    if (style != NULL && colors != NULL) {
+        style->colors = colors;
+        style->color_count = color_count;
+    }
+    return style;
+}
+
+/**
+ * \brief           Release style reference
+ * \note            Style memory is freed when last reference is released
+ * \param[in]       style: Style to release
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_release(gui_style_p style) {
+    GUI_ASSERTPARAMS(style != NULL && style->ref > 0);
+    
+    if (--style->ref == 0) {
+        GUI_MEMFREE(style);                         /* Colors allocated with style are freed too */
+    }
+    return 1;
+}
+
+/**
+ * \brief           Set colors of shared style
+ *
+ *                  All widgets using style are redrawn.
+ *                  This is the way to switch theme of many widgets at the same time
+ *
+ * \note            Colors array is not copied and must stay valid while style is in use,
+ *                  except when style holds its own colors array of the same number of colors.
+ *                  Then colors are copied to existing array
+ * \param[in]       style: Style handle
+ * \param[in]       colors: Pointer to colors in the same order as widget colors or `NULL` to use widget defaults
+ * \param[in]       color_count: Number of colors in array
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setcolors(gui_style_p style, const gui_color_t* colors, uint8_t color_count) {
+    GUI_ASSERTPARAMS(style != NULL);
+    
+    if (colors != NULL && style->flags & GUI_STYLE_FLAG_COLORS_ALLOC && style->color_count == color_count) {
+        if (colors != style->colors) {
+            memcpy((gui_color_t *)style->colors, colors, sizeof(*colors) * color_count);    /* Reuse allocated array */
+        }
+    } else {
+        style->colors = colors;                     /* Memory allocated with style is simply not used anymore */
+        style->color_count = colors != NULL ? color_count : 0;
+        style->flags &= ~GUI_STYLE_FLAG_COLORS_ALLOC;
+    }
+    refresh_style(style);
+    return 1;
+}
+
+/**
+ * \brief           Set font of shared style
+ * \param[in]       style: Style handle
+ * \param[in]       font: Font for widgets or `NULL` to keep font set on widget
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setfont(gui_style_p style, const gui_font_t* font) {
+    GUI_ASSERTPARAMS(style != NULL);
+    
+    style->font = font;
+    refresh_style(style);
+    return 1;
+}
+
+/**
+ * \brief           Set padding on all sides for widgets using shared style
+ * \param[in]       style: Style handle
+ * \param[in]       x: Padding in units of pixels
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_setpadding(gui_style_p style, gui_dim_t x) {
+    GUI_ASSERTPARAMS(style != NULL);
+    
+    style->padding = (uint32_t)((uint8_t)x) * 0x01010101UL; /* Same padding on all sides */
+    style->flags |= GUI_STYLE_FLAG_PADDING;
+    refresh_style(style);
+    return 1;
+}
+
+/**
+ * \brief           Set 3D mode for widgets using shared style
+ * \param[in]       style: Style handle
+ * \param[in]       enable: Set to `1` to enable 3D mode or `0` to disable it
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_style_set3d(gui_style_p style, uint8_t enable) {
+    GUI_ASSERTPARAMS(style != NULL);
+    
+    style->flags |= GUI_STYLE_FLAG_3D_SET;
+    if (enable) {
+        style->flags |= GUI_STYLE_FLAG_3D;
+    } else {
+        style->flags &= ~GUI_STYLE_FLAG_3D;
+    }
+    refresh_style(style);
+    return 1;
+}
+
+/**
+ * \brief           Set shared style to widget
+ * \param[in]       h: Widget handle
+ * \param[in]       style: Style handle or `NULL` to use widget defaults
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_setstyle(gui_handle_p h, gui_style_p style) {
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));
+    
+    if (h->style == style) {
+        return 1;
+    }
+    if (style != NULL) {
+        style->ref++;                               /* Widget holds reference */
+        style->users++;
+    }
+    if (h->style != NULL) {
+        h->style->users--;
+        gui_style_release(h->style);
+    }
+    h->style = style;
+    apply_style(h);
+    gui_widget_invalidate(h);
+    return 1;
+}
+
+/**
+ * \brief           Get style of widget
+ * \note            Returned style is not referenced again
+ * \param[in]       h: Widget handle
+ * \return          Pointer to style or `NULL` if widget uses defaults
+ */
+gui_style_p
+gui_widget_getstyle(gui_handle_p h) {
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));
+    return h->style;
+}
+
 /**
  * \brief           Set color to widget specific index
+ *
+ *                  When widget shares style with other widgets,
+ *                  it gets its own copy of style first (copy on write)
+ *
  * \param[in]       h: Widget handle
  * \param[in]       index: Index in array of colors
  * \param[in]       color: Actual color code to set
@@ -1206,31 +1988,58 @@ gui_widget_create(const gui_widget_t* widget, gui_id_t id, float x, float y, flo
  */
 uint8_t
 gui_widget_setcolor(gui_handle_p h, uint8_t index, gui_color_t color) {
-    uint8_t ret = 1;
+    gui_style_p style;
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    if (h->colors == NULL) {                        /* Do we need to allocate color memory? */
-        if (h->widget->color_count) {               /* Check if at least some colors should be used */
-            h->colors = GUI_MEMALLOC(sizeof(*h->colors) * h->widget->color_count);
-            if (h->colors != NULL) {                /* Copy all colors to new memory first */
-                memcpy(h->colors, h->widget->colors, sizeof(*h->colors) * h->widget->color_count);
-            } else {
-                ret = 0;
-            }
-        } else {
-            ret = 0;
-        }
+    if (index >= h->widget->color_count) {          /* Index must be in valid range */
+        return 0;
+    }
+    if ((style = detach_style(h, 1)) == NULL) {     /* Create private copy of style */
+        return 0;
     }
-    if (ret) {
-        if (index < h->widget->color_count) {       /* Index in valid range */
-           h->colors[index] = color;                /* Set new color */
+    ((gui_color_t *)style->colors)[index] = color;  /* Set new color */
+    
+    return 1;
+}
+
+/**
+ * \brief           Set 3D mode on widget
+ *
+ *                  When widget shares style which sets 3D mode,
+ *                  it gets its own copy of style first (copy on write)
+ *
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       h: Widget handle
+ * \param[in]       enable: Set to `1` to enable 3D mode, `0` otherwise
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_set3dstyle(gui_handle_p h, uint8_t enable) {
+    gui_style_p style;
+    
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));
+    
+    if (h->style != NULL && h->style->flags & GUI_STYLE_FLAG_3D_SET
+        && !!(h->style->flags & GUI_STYLE_FLAG_3D) != !!enable) {
+        if ((style = detach_style(h, 0)) == NULL) {
+            return 0;
+        }
+        if (enable) {
+            style->flags |= GUI_STYLE_FLAG_3D;
         } else {
-            ret = 0;
+            style->flags &= ~GUI_STYLE_FLAG_3D;
         }
     }
+    if (enable && !guii_widget_getflag(h, GUI_FLAG_3D)) {  /* Enable style */
+        guii_widget_setflag(h, GUI_FLAG_3D);        /* Enable 3D style */
+        gui_widget_invalidate(h);                   /* Invalidate object */
+    } else if (!enable && guii_widget_getflag(h, GUI_FLAG_3D)) {/* Disable style */
+        guii_widget_clrflag(h, GUI_FLAG_3D);        /* Disable 3D style */
+        gui_widget_invalidate(h);                   /* Invalidate object */
+    }
     
-    return ret;
+    return 1;
 }
 
 /**
@@ -1299,21 +2108,127 @@ gui_widget_empty(gui_handle_p h) {
 uint8_t
 gui_widget_isfontandtextset(gui_handle_p h) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
-    return h->text != NULL && h->font != NULL && gui_string_length(h->text);    /* Check if conditions are met for drawing string */
+    if (h->text == NULL || h->font == NULL) {
+        return 0;
+    }
+    return guii_widget_gettextlength(h) > 0;        /* Check if conditions are met for drawing string */
 }
 
 /**
- * \brief           Process text key (add character, remove it, move cursor, etc)
+ * \brief           Get number of bytes in previous character before text cursor
+ * \param[in]       h: Widget handle
+ * \return          Number of bytes of character in front of cursor
+ */
+static uint8_t
+text_prevchar_len(gui_handle_p h) {
+    uint8_t l = 1;
+#if GUI_CFG_USE_UNICODE
+    /* Skip UTF-8 continuation bytes */
+    while (l < 4 && l < h->textcursor && (h->text[h->textcursor - l] & 0xC0) == 0x80) {
+        l++;
+    }
+#endif /* GUI_CFG_USE_UNICODE */
+    return l;
+}
+
+/**
+ * \brief           Get number of bytes in next character after text cursor
+ * \param[in]       h: Widget handle
+ * \return          Number of bytes of character after cursor
+ */
+static uint8_t
+text_nextchar_len(gui_handle_p h) {
+    uint8_t l = 1;
+#if GUI_CFG_USE_UNICODE
+    uint8_t c = h->text[h->textcursor + h->textgaplen];
+    if ((c & 0xF8) == 0xF0) {                       /* Get length from UTF-8 start byte */
+        l = 4;
+    } else if ((c & 0xF0) == 0xE0) {
+        l = 3;
+    } else if ((c & 0xE0) == 0xC0) {
+        l = 2;
+    }
+#endif /* GUI_CFG_USE_UNICODE */
+    return l;
+}
+
+/**
+ * \brief           Open gap in text memory at cursor position
+ *
+ *                  Gap takes all free bytes of text memory.
+ *                  Text after cursor is moved to the end of memory only when gap is not yet opened,
+ *                  further insertions and deletions at cursor position do not move any bytes.
+ *
+ * \param[in]       h: Widget handle
+ */
+static void
+text_gap_open(gui_handle_p h) {
+    size_t tlen;
+    
+    if (h->textgaplen) {                            /* Gap is already opened */
+        return;
+    }
+    tlen = gui_string_lengthtotal(h->text);         /* Get total length of string */
+    if (h->textcursor > tlen) {                     /* Protect cursor position */
+        h->textcursor = tlen;
+    }
+    h->textgaplen = h->textmemsize - 1 - tlen;      /* Use all free memory for gap */
+    if (h->textgaplen) {
+        memmove(&h->text[h->textcursor + h->textgaplen], &h->text[h->textcursor], tlen - h->textcursor + 1); /* Move tail including trailing zero */
+        h->text[h->textcursor] = 0;                 /* Text before gap is always valid string */
+    }
+}
+
+/**
+ * \brief           Close gap in text memory and make text continuous again
+ * \param[in]       h: Widget handle
+ */
+static void
+text_gap_close(gui_handle_p h) {
+    if (h->textgaplen) {
+        memmove(&h->text[h->textcursor], &h->text[h->textcursor + h->textgaplen], h->textmemsize - h->textcursor - h->textgaplen); /* Move tail including trailing zero */
+        h->textgaplen = 0;
+    }
+}
+
+/**
+ * \brief           Get total number of bytes of widget text
+ * \note            Text gap is not included in result
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       h: Widget handle
+ * \return          Number of bytes of text
+ */
+size_t
+guii_widget_gettextlength(gui_handle_p h) {
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));
+    if (h->text == NULL) {
+        return 0;
+    }
+    if (h->textgaplen) {                            /* Text after gap always ends at the end of memory */
+        return h->textmemsize - 1 - h->textgaplen;
+    }
+    return gui_string_lengthtotal(gui_widget_gettext(h));
+}
+
+/**
+ * \brief           Process text key (add character, remove it, move cursor, etc) without widget invalidation
+ *
+ *                  Text memory is used as gap buffer, where gap is always at cursor position.
+ *                  Adding or removing character at cursor position only modifies gap size,
+ *                  moving cursor moves single character from one side of gap to another.
+ *
+ * \note            Caller is responsible for widget invalidation
  * \note            This function is private and may be called only when OS protection is active
  * \param[in]       h: Widget handle
  * \param[in]       kb: Pointer to \ref guii_keyboard_data_t structure
+ * \param[out]      pos: Pointer to output variable to save byte position in text where change started. Set to `NULL` if not used
+ * \param[out]      diff: Pointer to output variable to save number of bytes added (positive) or removed (negative). Set to `NULL` if not used
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
-guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* kb) {
-    size_t len, tlen;
+guii_widget_processtextkey_ex(gui_handle_p h, guii_keyboard_data_t* kb, size_t* pos, int32_t* diff) {
     uint32_t ch;
-    uint8_t l;
+    uint8_t l, i;
     gui_string_t currStr;
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
@@ -1327,42 +2242,96 @@ guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* kb) {
         return 0;                                   /* Invalid input key */
     }
     
-    tlen = gui_string_lengthtotal(h->text);         /* Get total length of string */
-    len = gui_string_length(h->text);               /* Get string length */
+    text_gap_open(h);                               /* Open gap at cursor position */
     if ((ch == GUI_KEY_LF || ch >= 32) && ch != 127) {  /* Check valid character character */
-        if (len < (h->textmemsize - l)) {           /* Memory still available for new character */
-            size_t pos;
-            for (pos = tlen + l - 1; pos > h->textcursor; pos--) {  /* Shift characters down */
-                h->text[pos] = h->text[pos - l];
+        if (h->textgaplen >= l) {                   /* Memory still available for new character */
+            if (pos != NULL) {
+                *pos = h->textcursor;
             }
-            for (pos = 0; pos < l; pos++) {         /* Fill new characters to empty memory */
-                h->text[h->textcursor++] = kb->kb.keys[pos];
+            for (i = 0; i < l; i++) {               /* Fill new characters to gap */
+                h->text[h->textcursor++] = kb->kb.keys[i];
+            }
+            h->textgaplen -= l;                     /* Decrease gap */
+            if (h->textgaplen) {
+                h->text[h->textcursor] = 0;         /* Text before gap is always valid string */
+            }
+            if (diff != NULL) {
+                *diff = (int32_t)l;
             }
-            h->text[tlen + l] = 0;                  /* Add 0 to the end */
-            
-            gui_widget_invalidate(h);               /* Invalidate widget */
             guii_widget_callback(h, GUI_EVT_TEXTCHANGED, NULL, NULL);   /* Process callback */
             return 1;
         }
-    } else if (ch == 8 || ch == 127) {              /* Backspace character */
-        if (tlen && h->textcursor) {
-            size_t pos;
-            
-            gui_string_prepare(&currStr, (gui_char *)((uint32_t)h->text + h->textcursor - 1));  /* Set string to process */
-            gui_string_gotoend(&currStr);           /* Go to the end of string */
-            if (!gui_string_getchreverse(&currStr, &ch, &l)) {  /* Get last character */
-                return 0;                           
+    } else if (ch == GUI_KEY_BACKSPACE || ch == 127) {  /* Backspace character */
+        if (h->textcursor) {
+            l = text_prevchar_len(h);               /* Get length of character to delete */
+            h->textcursor -= l;                     /* Character becomes part of gap */
+            h->textgaplen += l;
+            h->text[h->textcursor] = 0;             /* Text before gap is always valid string */
+            if (pos != NULL) {
+                *pos = h->textcursor;
             }
-            for (pos = h->textcursor - l; pos < (tlen - l); pos++) {/* Shift characters up */
-                h->text[pos] = h->text[pos + l];
+            if (diff != NULL) {
+                *diff = -(int32_t)l;
             }
-            h->textcursor -= l;                     /* Decrease text cursor by number of bytes for character deleted */
-            h->text[tlen - l] = 0;                  /* Set 0 to the end of string */
-            
-            gui_widget_invalidate(h);               /* Invalidate widget */
             guii_widget_callback(h, GUI_EVT_TEXTCHANGED, NULL, NULL);/* Process callback */
             return 1;
         }
+    } else if (ch == GUI_KEY_LEFT) {                /* Move cursor left */
+        if (h->textcursor) {
+            l = text_prevchar_len(h);
+            if (h->textgaplen) {
+                memmove(&h->text[h->textcursor + h->textgaplen - l], &h->text[h->textcursor - l], l);  /* Move character after gap */
+            }
+            h->textcursor -= l;
+            if (h->textgaplen) {
+                h->text[h->textcursor] = 0;         /* Text before gap is always valid string */
+            }
+            if (pos != NULL) {
+                *pos = h->textcursor;
+            }
+            if (diff != NULL) {
+                *diff = 0;
+            }
+            return 1;
+        }
+    } else if (ch == GUI_KEY_RIGHT) {               /* Move cursor right */
+        if ((h->textcursor + h->textgaplen) < (h->textmemsize - 1) && h->text[h->textcursor + h->textgaplen]) {
+            l = text_nextchar_len(h);
+            if (h->textgaplen) {
+                memmove(&h->text[h->textcursor], &h->text[h->textcursor + h->textgaplen], l);  /* Move character before gap */
+            }
+            h->textcursor += l;
+            if (h->textgaplen) {
+                h->text[h->textcursor] = 0;         /* Text before gap is always valid string */
+            }
+            if (pos != NULL) {
+                *pos = h->textcursor;
+            }
+            if (diff != NULL) {
+                *diff = 0;
+            }
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * \brief           Process text key (add character, remove it, move cursor, etc)
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       h: Widget handle
+ * \param[in]       kb: Pointer to \ref guii_keyboard_data_t structure
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_processtextkey(gui_handle_p h, guii_keyboard_data_t* kb) {
+    int32_t diff;
+    
+    if (guii_widget_processtextkey_ex(h, kb, NULL, &diff)) {
+        if (diff) {                                 /* Redraw only when text changed */
+            gui_widget_invalidate(h);               /* Invalidate widget */
+        }
+        return 1;
     }
     return 0;
 }
@@ -1383,15 +2352,18 @@ gui_widget_alloctextmemory(gui_handle_p h, uint32_t size) {
         h->textmemsize = 0;                         /* Reset memory size */
     }
     h->text = NULL;                                 /* Reset pointer */
+    h->textgaplen = 0;                              /* No gap in new memory */
+    h->textcursor = 0;                              /* Reset cursor */
 
     h->textmemsize = sizeof(gui_char) * (size + 1); /* Allocate text memory */
-    h->text = GUI_MEMALLOC(h->textmemsize);
+    h->text = GUI_MEMALLOC_TAG(h->textmemsize, GUI_MEM_TAG_TEXT);   /* Not movable, pointer is returned to user */
     if (h->text != NULL) {                          /* Check if allocated */
         guii_widget_setflag(h, GUI_FLAG_DYNAMICTEXTALLOC); /* Dynamically allocated */
     } else {
         h->textmemsize = 0;                         /* No dynamic bytes available */
         guii_widget_clrflag(h, GUI_FLAG_DYNAMICTEXTALLOC); /* Not allocated */
     }
+    guii_widget_setflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Text was replaced */
     gui_widget_invalidate(h);                       /* Redraw object */
     guii_widget_callback(h, GUI_EVT_TEXTCHANGED, NULL, NULL);   /* Process callback */
     
@@ -1413,7 +2385,10 @@ gui_widget_freetextmemory(gui_handle_p h) {
         GUI_MEMFREE(h->text);                       /* Free memory first */
         h->text = NULL;                             /* Reset memory */
         h->textmemsize = 0;                         /* Reset memory size */
+        h->textgaplen = 0;                          /* Reset gap */
+        h->textcursor = 0;                          /* Reset cursor */
         guii_widget_clrflag(h, GUI_FLAG_DYNAMICTEXTALLOC); /* Not allocated */
+        guii_widget_setflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Text was replaced */
         gui_widget_invalidate(h);                   /* Redraw object */
         guii_widget_callback(h, GUI_EVT_TEXTCHANGED, NULL, NULL);   /* Process callback */
         res = 1;
@@ -1435,7 +2410,9 @@ uint8_t
 gui_widget_settext(gui_handle_p h, const gui_char* text) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
+    guii_widget_setflag(h, GUI_FLAG_TEXT_RELAYOUT); /* Text was replaced */
     if (guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC)) {   /* Memory for text is dynamically allocated */
+        h->textgaplen = 0;                          /* Text is replaced, gap is not valid anymore */
         if (h->textmemsize) {
             if (gui_string_lengthtotal(text) > (h->textmemsize - 1)) {  /* Check string length */
                 gui_string_copyn(h->text, text, h->textmemsize - 1);    /* Do not copy all bytes because of memory overflow */
@@ -1465,6 +2442,9 @@ gui_widget_settext(gui_handle_p h, const gui_char* text) {
 /**
  * \brief           Get text from widget
  * \note            It will return pointer to text which cannot be modified directly.
+ * \note            If text is being edited, gap at cursor position is closed first
+ * \note            Dynamic text memory is never moved by memory compaction,
+ *                  returned pointer is valid until text memory is freed or reallocated
  * \param[in]       h: Widget handle
  * \return          Pointer to text from widget
  */
@@ -1474,6 +2454,8 @@ gui_widget_gettext(gui_handle_p h) {
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
+    text_gap_close(h);                              /* Make text continuous */
+    
 #if GUI_CFG_USE_TRANSLATE
     /* For static texts only */
     if (!guii_widget_getflag(h, GUI_FLAG_DYNAMICTEXTALLOC) && h->text != NULL) {
@@ -1490,37 +2472,54 @@ gui_widget_gettext(gui_handle_p h) {
 /**
  * \brief           Get text from widget
  * \note            Text from widget is copied to input pointer
+ * \note            Text being edited is copied from both sides of the gap, gap is not closed
  * \param[in]       h: Widget handle
  * \param[out]      dst: Destination pointer
  * \param[in]       len: Size of output buffer in units of \ref gui_char
- * \return          Pointer to text from widget
+ * \return          Pointer to copied text in destination memory
  */
 const gui_char*
 gui_widget_gettextcopy(gui_handle_p h, gui_char* dst, uint32_t len) {
-    const gui_char* t;
+    size_t n;
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
-    t = gui_widget_gettext(h);
-    gui_string_copyn(dst, t, len);
+    if (h->textgaplen) {                            /* Copy parts around the gap */
+        n = h->textcursor < len ? h->textcursor : len;
+        memcpy(dst, h->text, n);
+        gui_string_copyn(&dst[n], &h->text[h->textcursor + h->textgaplen], len - n);
+    } else {
+        gui_string_copyn(dst, gui_widget_gettext(h), len);
+    }
     dst[len] = 0;
     
-    return t;  
+    return dst;  
 }
 
 /**
  * \brief           Set widget font for drawing operations
+ *
+ *                  When widget shares style which sets font,
+ *                  it gets its own copy of style first (copy on write)
+ *
  * \param[in]       h: Widget handle
  * \param[in]       font: Pointer to \ref gui_font_t object for font
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setfont(gui_handle_p h, const gui_font_t* font) {
+    gui_style_p style;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
+    if (h->style != NULL && h->style->font != NULL && h->style->font != font) {
+        if ((style = detach_style(h, 0)) == NULL) {
+            return 0;
+        }
+        style->font = font;
+    }
     if (h->font != font) {
-        h->font = font;
-        gui_widget_invalidatewithparent(h);
+        set_widget_font(h, font);
     }
     
     return 1;
@@ -1552,19 +2551,19 @@ gui_widget_getfont(gui_handle_p h) {
  */
 uint8_t
 gui_widget_setsize(gui_handle_p h, gui_dim_t width, gui_dim_t height) {
-    return set_widget_size(h, GUI_FLOAT(width), GUI_FLOAT(height), 0, 0);
+    return set_widget_size(h, width, height, 0, 0);
 }
 
 /**
  * \brief           Set widget size in units of percent
  * \param[in]       h: Widget handle
- * \param[in]       width: Widget width
- * \param[in]       height: Widget height
+ * \param[in]       width: Widget width in percentage, clamped to range `0` to `GUI_PERCENT_MAX`
+ * \param[in]       height: Widget height in percentage, clamped to range `0` to `GUI_PERCENT_MAX`
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setsizepercent(gui_handle_p h, float width, float height) {
-    return set_widget_size(h, width, height, 1, 1);
+    return set_widget_size(h, size_from_float(width, 1), size_from_float(height, 1), 1, 1);
 }
 
 /**
@@ -1577,7 +2576,9 @@ gui_widget_setsizepercent(gui_handle_p h, float width, float height) {
  */
 uint8_t
 gui_widget_setsizeoriginal(gui_handle_p h, float width, float height) {
-    return set_widget_size(h, width, height,
+    return set_widget_size(h,
+        size_from_float(width, guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT),
+        size_from_float(height, guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT),
         guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT,
         guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT
     );
@@ -1591,7 +2592,7 @@ gui_widget_setsizeoriginal(gui_handle_p h, float width, float height) {
  */
 uint8_t
 gui_widget_setwidth(gui_handle_p h, gui_dim_t width) {
-    return set_widget_size(h, GUI_FLOAT(width), h->height,
+    return set_widget_size(h, width, h->height,
         0,
         guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT
     );
@@ -1600,12 +2601,12 @@ gui_widget_setwidth(gui_handle_p h, gui_dim_t width) {
 /**
  * \brief           Set width of widget in percentage relative to parent widget
  * \param[in]       h: Widget handle
- * \param[in]       width: Width in percentage
+ * \param[in]       width: Width in percentage, clamped to range `0` to `GUI_PERCENT_MAX`
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setwidthpercent(gui_handle_p h, float width) {
-    return set_widget_size(h, width, h->height,
+    return set_widget_size(h, size_from_float(width, 1), h->height,
         1,
         guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT
     );
@@ -1620,7 +2621,7 @@ gui_widget_setwidthpercent(gui_handle_p h, float width) {
  */
 uint8_t
 gui_widget_setwidthoriginal(gui_handle_p h, float width) {
-    return set_widget_size(h, width, h->height,
+    return set_widget_size(h, size_from_float(width, guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT), h->height,
         guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT,
         guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT
     );
@@ -1634,7 +2635,7 @@ gui_widget_setwidthoriginal(gui_handle_p h, float width) {
  */
 uint8_t
 gui_widget_setheight(gui_handle_p h, gui_dim_t height) {
-    return set_widget_size(h, h->width, GUI_FLOAT(height),
+    return set_widget_size(h, h->width, height,
         guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT,
         0
     );
@@ -1643,12 +2644,12 @@ gui_widget_setheight(gui_handle_p h, gui_dim_t height) {
 /**
  * \brief           Set height of widget in percentage relative to parent widget
  * \param[in]       h: Widget handle
- * \param[in]       height: Height in percentage
+ * \param[in]       height: Height in percentage, clamped to range `0` to `GUI_PERCENT_MAX`
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setheightpercent(gui_handle_p h, float height) {
-    return set_widget_size(h, h->width, height,
+    return set_widget_size(h, h->width, size_from_float(height, 1),
         guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT,
         1
     );
@@ -1663,7 +2664,7 @@ gui_widget_setheightpercent(gui_handle_p h, float height) {
  */
 uint8_t
 gui_widget_setheightoriginal(gui_handle_p h, float height) {
-    return set_widget_size(h, h->width, height,
+    return set_widget_size(h, h->width, size_from_float(height, guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT),
         guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT,
         guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT
     );
@@ -1695,11 +2696,8 @@ gui_widget_getwidth(gui_handle_p h) {
     
     GUI_ASSERTPARAMS(guii_widget_iswidget(h) && GUI.initialized); 
     
-#if GUI_CFG_USE_POS_SIZE_CACHE
+    update_widget_abs_values(h);                    /* Make sure cached values are valid */
     res = h->abs_width;                             /* Cached value */
-#else /* GUI_CFG_USE_POS_SIZE_CACHE */
-    res = calculate_widget_width(h);                /* Calculate value */
-#endif /* GUI_CFG_USE_POS_SIZE_CACHE */
     
     return res;
 }
@@ -1719,11 +2717,8 @@ gui_widget_getheight(gui_handle_p h) {
 
     GUI_ASSERTPARAMS(guii_widget_iswidget(h) && GUI.initialized); 
 
-#if GUI_CFG_USE_POS_SIZE_CACHE
+    update_widget_abs_values(h);                    /* Make sure cached values are valid */
     res = h->abs_height;                            /* Cached value */
-#else /* GUI_CFG_USE_POS_SIZE_CACHE */
-    res = calculate_widget_height(h);               /* Calculate value */
-#endif /* GUI_CFG_USE_POS_SIZE_CACHE */
 
     return res;
 }
@@ -1791,7 +2786,7 @@ gui_widget_getwidthoriginal(gui_handle_p h, uint8_t* is_percent) {
     if (is_percent != NULL) {
         *is_percent = guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT;
     }
-    return h->width;
+    return geometry_to_float(h->width, guii_widget_getflag(h, GUI_FLAG_WIDTH_PERCENT) == GUI_FLAG_WIDTH_PERCENT);
 }
 
 /**
@@ -1807,7 +2802,50 @@ gui_widget_getheightoriginal(gui_handle_p h, uint8_t* is_percent) {
     if (is_percent != NULL) {
         *is_percent = guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT;
     }
-    return h->height;
+    return geometry_to_float(h->height, guii_widget_getflag(h, GUI_FLAG_HEIGHT_PERCENT) == GUI_FLAG_HEIGHT_PERCENT);
+}
+
+/**
+ * \brief           Set layout for children widgets
+ *
+ *                  Position of all children and size in layout direction are set by layout.
+ *                  Children are arranged in single pass before next redraw, only when layout is modified
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       layout: Pointer to constant layout or `NULL` to place children manually
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setlayoutweight
+ */
+uint8_t
+gui_widget_setlayout(gui_handle_p h, const gui_layout_t* layout) {
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h) && guii_widget_allowchildren(h));
+    
+    h->layout = layout;
+    set_layout_dirty(h);
+    return 1;
+}
+
+/**
+ * \brief           Set weight of widget in parent layout
+ *
+ *                  In row and column layouts, free space is shared between children with weight,
+ *                  proportionally to their weights. Children with weight `0` keep their size.
+ *                  In grid layout weight is number of columns used by widget
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       weight: Widget weight
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_setlayout
+ */
+uint8_t
+gui_widget_setlayoutweight(gui_handle_p h, uint8_t weight) {
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));
+    
+    if (h->layout_weight != weight) {
+        h->layout_weight = weight;
+        set_layout_dirty(guii_widget_getparent(h));
+    }
+    return 1;
 }
 
 /**
@@ -1828,10 +2866,14 @@ gui_widget_setexpanded(gui_handle_p h, uint8_t state) {
         /* TODO: Force invalidation even if ignored */
         gui_widget_invalidatewithparent(h);         /* Invalidate with parent first for clipping region */
         guii_widget_clrflag(h, GUI_FLAG_EXPANDED);  /* Clear expanded after invalidation */
-        SET_WIDGET_ABS_VALUES(h);                   /* Set widget absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate widget absolute values */
+        set_layout_dirty(h);                        /* Arrange children for new size */
+        set_children_layout_dirty(h);
     } else if (state && !is_expanded) {
         guii_widget_setflag(h, GUI_FLAG_EXPANDED);  /* Expand widget */
-        SET_WIDGET_ABS_VALUES(h);                   /* Set widget absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate widget absolute values */
+        set_layout_dirty(h);                        /* Arrange children for new size */
+        set_children_layout_dirty(h);
         gui_widget_invalidate(h);                   /* Redraw only selected widget as it is over all window */
     }
     
@@ -1863,19 +2905,19 @@ gui_widget_isexpanded(gui_handle_p h) {
  */
 uint8_t
 gui_widget_setposition(gui_handle_p h, gui_dim_t x, gui_dim_t y) {
-    return set_widget_position(h, GUI_FLOAT(x), GUI_FLOAT(y), 0, 0);
+    return set_widget_position(h, x, y, 0, 0);
 }
 
 /**
  * \brief           Set widget position relative to parent object in units of percent
  * \param[in]       h: Widget handle
- * \param[in]       x: X position relative to parent object
- * \param[in]       y: Y position relative to parent object
+ * \param[in]       x: X position relative to parent object, clamped to range `-GUI_PERCENT_MAX` to `GUI_PERCENT_MAX`
+ * \param[in]       y: Y position relative to parent object, clamped to range `-GUI_PERCENT_MAX` to `GUI_PERCENT_MAX`
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setpositionpercent(gui_handle_p h, float x, float y) {
-    return set_widget_position(h, x, y, 1, 1);
+    return set_widget_position(h, geometry_from_float(x, 1), geometry_from_float(y, 1), 1, 1);
 }
 
 /**
@@ -1888,7 +2930,9 @@ gui_widget_setpositionpercent(gui_handle_p h, float x, float y) {
  */
 uint8_t
 gui_widget_setpositionoriginal(gui_handle_p h, float x, float y) {
-    return set_widget_position(h, x, y,
+    return set_widget_position(h,
+        geometry_from_float(x, guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT),
+        geometry_from_float(y, guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT),
         guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT,
         guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT
     );
@@ -1902,7 +2946,7 @@ gui_widget_setpositionoriginal(gui_handle_p h, float x, float y) {
  */
 uint8_t
 gui_widget_setxposition(gui_handle_p h, gui_dim_t x) {
-    return set_widget_position(h, GUI_FLOAT(x), h->y,
+    return set_widget_position(h, x, h->y,
         0,
         guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT
     );
@@ -1911,12 +2955,12 @@ gui_widget_setxposition(gui_handle_p h, gui_dim_t x) {
 /**
  * \brief           Set widget `X` position relative to parent object in units of percent
  * \param[in]       h: Widget handle
- * \param[in]       x: X position relative to parent object
+ * \param[in]       x: X position relative to parent object, clamped to range `-GUI_PERCENT_MAX` to `GUI_PERCENT_MAX`
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setxpositionpercent(gui_handle_p h, float x) {
-    return set_widget_position(h, x, h->y,
+    return set_widget_position(h, geometry_from_float(x, 1), h->y,
         1,
         guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT
     );
@@ -1930,7 +2974,7 @@ gui_widget_setxpositionpercent(gui_handle_p h, float x) {
  * \return          `1` on success, `0` otherwise
  */uint8_t
 gui_widget_setxpositionoriginal(gui_handle_p h, float x) {
-    return set_widget_position(h, x, h->y,
+    return set_widget_position(h, geometry_from_float(x, guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT), h->y,
         guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT,
         guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT
     );
@@ -1944,7 +2988,7 @@ gui_widget_setxpositionoriginal(gui_handle_p h, float x) {
  */
 uint8_t
 gui_widget_setyposition(gui_handle_p h, gui_dim_t y) {
-    return set_widget_position(h, h->x, GUI_FLOAT(y),
+    return set_widget_position(h, h->x, y,
         guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT,
         0
     );
@@ -1953,12 +2997,12 @@ gui_widget_setyposition(gui_handle_p h, gui_dim_t y) {
 /**
  * \brief           Set widget `Y` position relative to parent object in units of percent
  * \param[in]       h: Widget handle
- * \param[in]       y: Y position relative to parent object
+ * \param[in]       y: Y position relative to parent object, clamped to range `-GUI_PERCENT_MAX` to `GUI_PERCENT_MAX`
  * \return          `1` on success, `0` otherwise
  */
 uint8_t
 gui_widget_setypositionpercent(gui_handle_p h, float y) {
-    return set_widget_position(h, h->x, y,
+    return set_widget_position(h, h->x, geometry_from_float(y, 1),
         guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT,
         1
     );
@@ -1973,7 +3017,7 @@ gui_widget_setypositionpercent(gui_handle_p h, float y) {
  */
 uint8_t
 gui_widget_setypositionoriginal(gui_handle_p h, float y) {
-    return set_widget_position(h, h->x, y,
+    return set_widget_position(h, h->x, geometry_from_float(y, guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT),
         guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT,
         guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT
     );
@@ -1992,7 +3036,7 @@ gui_widget_getxpositionoriginal(gui_handle_p h, uint8_t* is_percent) {
     if (is_percent != NULL) {
         *is_percent = guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT;
     }
-    return h->x;
+    return geometry_to_float(h->x, guii_widget_getflag(h, GUI_FLAG_XPOS_PERCENT) == GUI_FLAG_XPOS_PERCENT);
 }
 
 /**
@@ -2008,7 +3052,7 @@ gui_widget_getypositionoriginal(gui_handle_p h, uint8_t* is_percent) {
     if (is_percent != NULL) {
         *is_percent = guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT;
     }
-    return h->y;
+    return geometry_to_float(h->y, guii_widget_getflag(h, GUI_FLAG_YPOS_PERCENT) == GUI_FLAG_YPOS_PERCENT);
 }
 
 /**
@@ -2036,6 +3080,61 @@ gui_widget_invalidate(gui_handle_p h) {
     return res;
 }
 
+/**
+ * \brief           Invalidate only part of widget and prepare to new redraw
+ *
+ *                  Widget is redrawn on next redraw cycle but clipping region
+ *                  is expanded only for requested rectangle instead of entire widget
+ *
+ * \note            If widget requires parent invalidation, entire widget is invalidated instead
+ * \note            This function is private and may be called only when OS protection is active
+ * \param[in]       h: Widget handle
+ * \param[in]       x: Rectangle `X` position relative to widget
+ * \param[in]       y: Rectangle `Y` position relative to widget
+ * \param[in]       width: Rectangle width in units of pixels
+ * \param[in]       height: Rectangle height in units of pixels
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+guii_widget_invalidaterect(gui_handle_p h, gui_dim_t x, gui_dim_t y, gui_dim_t width, gui_dim_t height) {
+    gui_dim_t x1, y1, x2, y2, ax, ay;
+    uint8_t res;
+    
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));
+    
+    if (guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE) || width <= 0 || height <= 0) {
+        return 0;
+    }
+    if (guii_widget_hasparent(h) && (
+            guii_widget_getflag(h, GUI_FLAG_WIDGET_INVALIDATE_PARENT) || 
+            guii_widget_getcoreflag(h, GUI_FLAG_WIDGET_INVALIDATE_PARENT) ||
+            guii_widget_hasalpha(h)
+        )) {
+        return gui_widget_invalidate(h);            /* Parent must be redrawn, invalidate entire widget */
+    }
+    
+    res = invalidate_widget(h, 0);                  /* Invalidate widget without clipping */
+    if (res) {
+        guii_widget_getabsvisibleposition(h, &x1, &y1, &x2, &y2);
+        ax = gui_widget_getabsolutex(h) + x;        /* Get absolute rectangle position */
+        ay = gui_widget_getabsolutey(h) + y;
+        
+        /* Limit rectangle to visible part of widget */
+        if (x1 < ax)            { x1 = ax; }
+        if (y1 < ay)            { y1 = ay; }
+        if (x2 > ax + width)    { x2 = ax + width; }
+        if (y2 > ay + height)   { y2 = ay + height; }
+        
+        if (x1 < x2 && y1 < y2) {
+            if (GUI.display.x1 > x1)    { GUI.display.x1 = x1; }
+            if (GUI.display.x2 < x2)    { GUI.display.x2 = x2; }
+            if (GUI.display.y1 > y1)    { GUI.display.y1 = y1; }
+            if (GUI.display.y2 < y2)    { GUI.display.y2 = y2; }
+        }
+    }
+    return res;
+}
+
 uint8_t
 gui_widget_force_invalidate(gui_handle_p h) {
     /* TODO: Clear ignore invalidate flag, invalidate, set it back (if it was set before clearing it) */
@@ -2076,6 +3175,258 @@ gui_widget_setignoreinvalidate(gui_handle_p h, uint8_t en, uint8_t invalidate) {
     return res;
 }
 
+/**
+ * \brief           Start update transaction for widgets
+ *
+ *                  Until transaction ends, any widget invalidation only marks widget as pending.
+ *                  Clipping region, redraw flags and widgets overlapping invalidated ones are processed once per widget
+ *                  when \ref gui_widget_update_end is called, no matter how many times widget was invalidated.
+ *
+ * \note            Transactions may be nested, processing is done when outer transaction ends
+ * \note            Every call must be followed by \ref gui_widget_update_end call
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_update_end
+ */
+uint8_t
+gui_widget_update_begin(void) {
+    GUI.update_level++;                             /* Increase nesting level */
+    return 1;
+}
+
+/**
+ * \brief           End update transaction for widgets and process all deferred invalidations
+ * \return          `1` on success, `0` otherwise
+ * \sa              gui_widget_update_begin
+ */
+uint8_t
+gui_widget_update_end(void) {
+    GUI_ASSERTPARAMS(GUI.update_level > 0);
+    
+    if (--GUI.update_level == 0 && GUI.update_pending) {
+        process_pending_invalidations(NULL);        /* Process all widgets invalidated in transaction */
+    }
+    return 1;
+}
+
+/**
+ * \brief           Drop deferred invalidation of children widgets
+ * \note            Used when children are redrawn together with parent widget
+ * \param[in]       h: Parent widget handle
+ */
+static void
+drop_children_pending(gui_handle_p h) {
+    gui_handle_p c;
+    
+    if (guii_widget_haschildren(h)) {
+        GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+            if (guii_widget_getflag(c, GUI_FLAG_INVALIDATE_PENDING)) {
+                guii_widget_clrflag(c, GUI_FLAG_INVALIDATE_PENDING | GUI_FLAG_INVALIDATE_CLIPPING);
+                GUI.update_pending--;
+            }
+        }
+    }
+}
+
+/**
+ * \brief           Create widgets from tree nodes and their children
+ * \param[in]       tree: Array of tree nodes
+ * \param[in]       count: Number of nodes in array
+ * \param[in]       parent: Parent widget handle
+ * \return          Handle of first created widget on success, `NULL` otherwise
+ */
+static gui_handle_p
+create_tree_nodes(const gui_widget_tree_t* tree, size_t count, gui_handle_p parent) {
+    gui_handle_p h, first = NULL;
+    gui_style_p style = NULL;
+    uint8_t f;
+    
+    for (; count > 0; count--, tree++) {
+        f = tree->tree_flags;
+        h = tree->create(tree->id, tree->x, tree->y, tree->width, tree->height, parent, tree->callback, tree->flags | GUI_FLAG_WIDGET_CREATE_IGNORE_INVALIDATE);
+        if (h == NULL) {                            /* Skip node and its children on failure */
+            continue;
+        }
+        
+        /* Geometry in percents is set again with proper units, widget was not drawn with pixel values yet */
+        guii_widget_setflag(h, GUI_FLAG_FIRST_INVALIDATE);
+        if (f & (GUI_FLAG_WIDGET_TREE_WIDTH_PERCENT | GUI_FLAG_WIDGET_TREE_HEIGHT_PERCENT)) {
+            set_widget_size(h,
+                size_from_float(tree->width, !!(f & GUI_FLAG_WIDGET_TREE_WIDTH_PERCENT)),
+                size_from_float(tree->height, !!(f & GUI_FLAG_WIDGET_TREE_HEIGHT_PERCENT)),
+                !!(f & GUI_FLAG_WIDGET_TREE_WIDTH_PERCENT), !!(f & GUI_FLAG_WIDGET_TREE_HEIGHT_PERCENT));
+        }
+        if (f & (GUI_FLAG_WIDGET_TREE_XPOS_PERCENT | GUI_FLAG_WIDGET_TREE_YPOS_PERCENT)) {
+            set_widget_position(h,
+                geometry_from_float(tree->x, !!(f & GUI_FLAG_WIDGET_TREE_XPOS_PERCENT)),
+                geometry_from_float(tree->y, !!(f & GUI_FLAG_WIDGET_TREE_YPOS_PERCENT)),
+                !!(f & GUI_FLAG_WIDGET_TREE_XPOS_PERCENT), !!(f & GUI_FLAG_WIDGET_TREE_YPOS_PERCENT));
+        }
+        if (tree->zindex) {
+            gui_widget_setzindex(h, tree->zindex);
+        }
+        if (tree->text != NULL) {
+            gui_widget_settext(h, tree->text);
+        }
+        if (tree->colors != NULL && tree->colors_count) {
+            if (style == NULL || style->colors != tree->colors || style->color_count != tree->colors_count) {
+                if (style != NULL) {
+                    gui_style_release(style);
+                }
+                style = gui_style_create(tree->colors, tree->colors_count); /* Shared by nodes with the same colors */
+            }
+            if (style != NULL) {
+                gui_widget_setstyle(h, style);
+            }
+        }
+        if (tree->arg != NULL) {
+            gui_widget_setuserdata(h, tree->arg);
+        }
+        if (f & GUI_FLAG_WIDGET_TREE_HIDDEN) {
+            guii_widget_setflag(h, GUI_FLAG_HIDDEN);    /* New widget cannot be focused or active yet */
+        }
+        if (f & GUI_FLAG_WIDGET_TREE_DEFERRED) {    /* Children are created on first show */
+            h->tree = tree;
+            gui_widget_setdeferred(h, !!(f & GUI_FLAG_WIDGET_TREE_RELEASE));
+        } else if (tree->children_count) {
+            create_tree_nodes(tree->children, tree->children_count, h);
+        }
+        drop_children_pending(h);                   /* Children are redrawn with new parent */
+        if (!(tree->flags & GUI_FLAG_WIDGET_CREATE_IGNORE_INVALIDATE)) {
+            guii_widget_clrflag(h, GUI_FLAG_IGNORE_INVALIDATE);
+            if (!(f & GUI_FLAG_WIDGET_TREE_HIDDEN)) {
+                gui_widget_invalidate(h);           /* Clipping region from final geometry with percents resolved */
+            }
+        }
+        if (first == NULL) {
+            first = h;
+        }
+    }
+    if (style != NULL) {
+        gui_style_release(style);                   /* Widgets hold their own references */
+    }
+    return first;
+}
+
+/**
+ * \brief           Create widgets from constant tree description
+ *
+ *                  Widgets are created, configured and linked in single pass.
+ *                  Invalidation is done once per top-level node, when all widgets are created.
+ *
+ * \note            Tree may be placed in read-only memory
+ * \param[in]       tree: Array of top-level tree nodes
+ * \param[in]       count: Number of nodes in array
+ * \param[in]       parent: Parent widget handle for top-level nodes
+ * \return          Handle of first created top-level widget on success, `NULL` otherwise
+ */
+gui_handle_p
+gui_widget_create_tree(const gui_widget_tree_t* tree, size_t count, gui_handle_p parent) {
+    gui_handle_p first;
+    
+    GUI_ASSERTPARAMS(tree != NULL && count > 0);
+    
+    gui_widget_update_begin();                      /* Defer all invalidations */
+    first = create_tree_nodes(tree, count, parent);
+    gui_widget_update_end();                        /* Invalidate top-level widgets */
+    return first;
+}
+
+/**
+ * \brief           Create children widgets of deferred widget
+ * \param[in]       h: Widget handle
+ */
+static void
+build_deferred_children(gui_handle_p h) {
+    gui_handle_p c;
+    uint8_t is_flag;
+    
+    guii_widget_clrflag(h, GUI_FLAG_DEFERRED);
+    
+    /* Children released on hide but not yet removed are used again */
+    if (guii_widget_haschildren(h)) {
+        GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+            guii_widget_clrflag(c, GUI_FLAG_REMOVE);
+        }
+        return;
+    }
+    
+    is_flag = !!guii_widget_getflag(h, GUI_FLAG_IGNORE_INVALIDATE);
+    guii_widget_setflag(h, GUI_FLAG_IGNORE_INVALIDATE); /* Widget is invalidated by caller */
+    gui_widget_update_begin();
+    if (h->tree != NULL && h->tree->children_count) {
+        create_tree_nodes(h->tree->children, h->tree->children_count, h);
+    } else {
+        guii_widget_callback(h, GUI_EVT_BUILDCHILDREN, NULL, NULL); /* Let user create children */
+    }
+    drop_children_pending(h);
+    if (!is_flag) {
+        guii_widget_clrflag(h, GUI_FLAG_IGNORE_INVALIDATE);
+    }
+    gui_widget_update_end();
+}
+
+#if GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE
+
+/**
+ * \brief           Release children widgets of hidden deferred widget
+ * \note            Children are removed on next remove processing and created again on next show
+ * \param[in]       h: Widget handle
+ */
+static void
+release_deferred_children(gui_handle_p h) {
+    gui_handle_p c;
+    
+    if (!guii_widget_haschildren(h)) {
+        return;
+    }
+    GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+        if (!can_remove_widget(c)) {                /* Keep all children if any cannot be removed */
+            return;
+        }
+    }
+    GUI_LINKEDLIST_WIDGETSLISTNEXT(h, c) {
+        guii_widget_setflag(c, GUI_FLAG_REMOVE);
+    }
+    guii_widget_setflag(h, GUI_FLAG_DEFERRED);
+    GUI.flags |= GUI_FLAG_REMOVE;                   /* Set flag for to remove at least one widget from tree */
+#if GUI_CFG_OS
+    gui_sys_mbox_putnow(&GUI.OS.mbox, NULL);        /* Put message to queue */
+#endif /* GUI_CFG_OS */
+}
+
+#endif /* GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE */
+
+/**
+ * \brief           Set widget as deferred, its children are created on first show
+ *
+ *                  Children are created from tree node when widget was created with \ref gui_widget_create_tree,
+ *                  otherwise \ref GUI_EVT_BUILDCHILDREN event is sent to widget callback.
+ *                  If widget is visible and has no children, they are created immediately
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       release: Set to `1` to release children when widget is hidden
+ *                      and free memory is below \ref GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+gui_widget_setdeferred(gui_handle_p h, uint8_t release) {
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h) && guii_widget_allowchildren(h));
+    
+    if (release) {
+        guii_widget_setflag(h, GUI_FLAG_DEFERRED_RELEASE);
+    } else {
+        guii_widget_clrflag(h, GUI_FLAG_DEFERRED_RELEASE);
+    }
+    if (!guii_widget_haschildren(h)) {
+        guii_widget_setflag(h, GUI_FLAG_DEFERRED);
+        if (!guii_widget_getflag(h, GUI_FLAG_HIDDEN)) {
+            build_deferred_children(h);             /* Visible widget needs children now */
+            gui_widget_invalidate(h);
+        }
+    }
+    return 1;
+}
+
 /**
  * \brief           Show widget from visible area
  * \param[in]       h: Widget handle
@@ -2086,7 +3437,11 @@ gui_widget_show(gui_handle_p h) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     
     if (guii_widget_getflag(h, GUI_FLAG_HIDDEN)) {  /* If hidden, show it */
+        if (guii_widget_getflag(h, GUI_FLAG_DEFERRED)) {
+            build_deferred_children(h);             /* Create children on first show */
+        }
         guii_widget_clrflag(h, GUI_FLAG_HIDDEN);
+        set_layout_dirty(guii_widget_getparent(h)); /* Hidden widgets are not part of layout */
         gui_widget_invalidatewithparent(h);         /* Invalidate it for redraw with parent */
     }
     
@@ -2130,6 +3485,12 @@ gui_widget_hide(gui_handle_p h) {
         }
         gui_widget_invalidatewithparent(h);         /* Invalidate it for redraw with parent */
         guii_widget_setflag(h, GUI_FLAG_HIDDEN);    /* Hide widget */
+        set_layout_dirty(guii_widget_getparent(h)); /* Hidden widgets are not part of layout */
+#if GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE
+        if (guii_widget_getflag(h, GUI_FLAG_DEFERRED_RELEASE) && gui_mem_getfree() < GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE) {
+            release_deferred_children(h);           /* Free memory while widget is not visible */
+        }
+#endif /* GUI_CFG_WIDGET_DEFERRED_RELEASE_FREE */
     }
     
     return 1;
@@ -2178,7 +3539,8 @@ gui_widget_getparent(gui_handle_p h) {
 
 /**
  * \brief           Get first widget handle by ID
- * \note            If multiple widgets have the same ID, first found will be used
+ * \note            If multiple widgets have the same ID, widget created first is used
+ * \note            ID `0` means widget without ID and it is never found
  * \param[in,out]   id: Widget ID to search for
  * \return          Widget handle on success, `NULL` otherwise
  */
@@ -2189,7 +3551,7 @@ gui_widget_getbyid(gui_id_t id) {
 
 /**
  * \brief           Get first widget handle by ID on specific parent widget
- * \note            If multiple widgets have the same ID, first found will be used
+ * \note            If multiple widgets have the same ID on parent, widget created first is used
  *
  * \note            This function is private and may be called only when OS protection is active
  * \param[in,out]   id: Widget ID to search for
@@ -2318,7 +3680,7 @@ gui_widget_setscrollx(gui_handle_p h, gui_dim_t scroll) {
     
     if (h->x_scroll != scroll) {
         h->x_scroll = scroll;
-        SET_WIDGET_ABS_VALUES(h);                   /* Set new absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate absolute values */
         gui_widget_invalidate(h);                   /* Invalidate widget */
         ret = 1;
     }
@@ -2340,7 +3702,7 @@ gui_widget_setscrolly(gui_handle_p h, gui_dim_t scroll) {
     
     if (h->y_scroll != scroll) {
         h->y_scroll = scroll;
-        SET_WIDGET_ABS_VALUES(h);                   /* Set new absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate absolute values */
         gui_widget_invalidate(h);                   /* Invalidate widget */
         ret = 1;
     }
@@ -2363,7 +3725,7 @@ gui_widget_incscrollx(gui_handle_p h, gui_dim_t scroll) {
     
     if (scroll) {
         h->x_scroll += scroll;
-        SET_WIDGET_ABS_VALUES(h);                   /* Set new absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate absolute values */
         gui_widget_invalidate(h);                   /* Invalidate widget */
         ret = 1;
     }
@@ -2386,7 +3748,7 @@ gui_widget_incscrolly(gui_handle_p h, gui_dim_t scroll) {
     
     if (scroll) {
         h->y_scroll += scroll;
-        SET_WIDGET_ABS_VALUES(h);                   /* Set new absolute values */
+        set_widget_geometry_dirty(h);               /* Invalidate absolute values */
         gui_widget_invalidate(h);                   /* Invalidate widget */
         ret = 1;
     }
@@ -2509,7 +3871,6 @@ gui_widget_setalpha(gui_handle_p h, uint8_t alpha) {
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
     if (h->alpha != alpha) {                        /* Check transparency match */
         h->alpha = alpha;                           /* Set new transparency level */
-        SET_WIDGET_ABS_VALUES(h);                   /* Set widget absolute values */
         gui_widget_invalidate(h);                   /* Invalidate widget */
         ret = 1;
     }
@@ -2541,6 +3902,34 @@ gui_widget_getalpha(gui_handle_p h) {
     return a;
 }
 
+/**
+ * \brief           Set widget padding and mark geometry as changed
+ *
+ *                  When widget shares style which sets padding,
+ *                  it gets its own copy of style first (copy on write)
+ *
+ * \param[in]       h: Widget handle
+ * \param[in]       padding: Padding for all sides in widget padding format
+ * \return          `1` on success, `0` otherwise
+ */
+static uint8_t
+set_widget_padding(gui_handle_p h, uint32_t padding) {
+    gui_style_p style;
+    
+    if (h->style != NULL && h->style->flags & GUI_STYLE_FLAG_PADDING && h->style->padding != padding) {
+        if ((style = detach_style(h, 0)) == NULL) {
+            return 0;
+        }
+        style->padding = padding;
+    }
+    h->padding = padding;
+    set_widget_geometry_dirty(h);
+    set_layout_dirty(h);                            /* Area for children has changed */
+    set_children_layout_dirty(h);
+    
+    return 1;
+}
+
 /**
  * \brief           Set widget top padding
  * \param[in]       h: Widget handle
@@ -2549,12 +3938,13 @@ gui_widget_getalpha(gui_handle_p h) {
  */
 uint8_t
 gui_widget_setpaddingtop(gui_handle_p h, gui_dim_t x) {
+    uint32_t padding;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    h->padding = (uint32_t)((h->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)x) << 24);/* Padding top */
-    SET_WIDGET_ABS_VALUES(h);
+    padding = (uint32_t)((h->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)x) << 24);/* Padding top */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**
@@ -2565,12 +3955,13 @@ gui_widget_setpaddingtop(gui_handle_p h, gui_dim_t x) {
  */
 uint8_t
 gui_widget_setpaddingright(gui_handle_p h, gui_dim_t x) {
+    uint32_t padding;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    h->padding = (uint32_t)((h->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)x) << 16);/* Padding right */
-    SET_WIDGET_ABS_VALUES(h);
+    padding = (uint32_t)((h->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)x) << 16);/* Padding right */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**
@@ -2581,12 +3972,13 @@ gui_widget_setpaddingright(gui_handle_p h, gui_dim_t x) {
  */
 uint8_t
 gui_widget_setpaddingbottom(gui_handle_p h, gui_dim_t x) {
+    uint32_t padding;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    h->padding = (uint32_t)((h->padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)x) << 8); /* Padding bottom */
-    SET_WIDGET_ABS_VALUES(h);
+    padding = (uint32_t)((h->padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)x) << 8); /* Padding bottom */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**
@@ -2597,12 +3989,13 @@ gui_widget_setpaddingbottom(gui_handle_p h, gui_dim_t x) {
  */
 uint8_t
 gui_widget_setpaddingleft(gui_handle_p h, gui_dim_t x) {
+    uint32_t padding;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    h->padding = (uint32_t)((h->padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)x) << 0); /* Padding left */
-    SET_WIDGET_ABS_VALUES(h);
+    padding = (uint32_t)((h->padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)x) << 0); /* Padding left */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**
@@ -2613,13 +4006,14 @@ gui_widget_setpaddingleft(gui_handle_p h, gui_dim_t x) {
  */
 uint8_t
 gui_widget_setpaddingtopbottom(gui_handle_p h, gui_dim_t x) {
+    uint32_t padding;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    h->padding = (uint32_t)((h->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)x) << 24);/* Padding top */
-    h->padding = (uint32_t)((h->padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)x) << 8); /* Padding bottom */
-    SET_WIDGET_ABS_VALUES(h);
+    padding = (uint32_t)((h->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)x) << 24);/* Padding top */
+    padding = (uint32_t)((padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)x) << 8); /* Padding bottom */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**
@@ -2630,13 +4024,14 @@ gui_widget_setpaddingtopbottom(gui_handle_p h, gui_dim_t x) {
  */
 uint8_t
 gui_widget_setpaddingleftright(gui_handle_p h, gui_dim_t x) {
+    uint32_t padding;
+    
     GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
 
-    h->padding = (uint32_t)((h->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)x) << 16);/* Padding right */
-    h->padding = (uint32_t)((h->padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)x) << 0); /* Padding left */
-    SET_WIDGET_ABS_VALUES(h);
+    padding = (uint32_t)((h->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)x) << 16);/* Padding right */
+    padding = (uint32_t)((padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)x) << 0); /* Padding left */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**
@@ -2647,15 +4042,16 @@ gui_widget_setpaddingleftright(gui_handle_p h, gui_dim_t x) {
  */
 uint8_t
 gui_widget_setpadding(gui_handle_p h, gui_dim_t x) {
-    GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
+    uint32_t padding;
     
-    h->padding = (uint32_t)((h->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)x) << 24);/* Padding top */
-    h->padding = (uint32_t)((h->padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)x) << 16);/* Padding right */
-    h->padding = (uint32_t)((h->padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)x) << 8); /* Padding bottom */
-    h->padding = (uint32_t)((h->padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)x) << 0); /* Padding left */
-    SET_WIDGET_ABS_VALUES(h);
+    GUI_ASSERTPARAMS(guii_widget_iswidget(h));    
+
+    padding = (uint32_t)((h->padding & 0x00FFFFFFUL) | (uint32_t)((uint8_t)x) << 24);/* Padding top */
+    padding = (uint32_t)((padding & 0xFF00FFFFUL) | (uint32_t)((uint8_t)x) << 16);/* Padding right */
+    padding = (uint32_t)((padding & 0xFFFF00FFUL) | (uint32_t)((uint8_t)x) << 8); /* Padding bottom */
+    padding = (uint32_t)((padding & 0xFFFFFF00UL) | (uint32_t)((uint8_t)x) << 0); /* Padding left */
     
-    return 1;
+    return set_widget_padding(h, padding);
 }
 
 /**